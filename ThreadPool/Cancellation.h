@@ -0,0 +1,176 @@
+﻿/// <summary>
+/// 协作式取消头文件 - 取消源、取消令牌与取消异常
+/// </summary>
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/// <summary>
+/// 任务被取消、超过截止时间或因线程池停止被丢弃时，future中保存的异常
+/// </summary>
+class TaskCancelledException : public std::runtime_error
+{
+public:
+    TaskCancelledException()
+        : std::runtime_error("Task was cancelled")
+    {
+    }
+};
+
+/// <summary>
+/// 取消状态，由取消源与令牌共享
+/// </summary>
+struct ST_CancellationState
+{
+    std::atomic<bool> m_cancelled{false}; ///< 是否已请求取消
+};
+
+/// <summary>
+/// 取消令牌，只能查询是否已请求取消；默认构造的令牌永远不会被取消
+/// 复制令牌只增加共享状态的引用计数，可以随任务一起传递
+/// </summary>
+class CancellationToken
+{
+public:
+    CancellationToken() = default;
+
+    /// <summary>
+    /// 是否已请求取消
+    /// </summary>
+    bool IsCancellationRequested() const
+    {
+        return m_state != nullptr && m_state->m_cancelled.load(std::memory_order_acquire);
+    }
+
+    /// <summary>
+    /// 令牌是否关联了取消源
+    /// </summary>
+    bool CanBeCancelled() const { return m_state != nullptr; }
+
+    /// <summary>
+    /// 已请求取消时抛出TaskCancelledException，供长任务在执行中途检查
+    /// </summary>
+    void ThrowIfCancellationRequested() const
+    {
+        if (IsCancellationRequested())
+        {
+            throw TaskCancelledException();
+        }
+    }
+
+private:
+    friend class CancellationSource;
+
+    explicit CancellationToken(std::shared_ptr<const ST_CancellationState> state)
+        : m_state(std::move(state))
+    {
+    }
+
+private:
+    std::shared_ptr<const ST_CancellationState> m_state; ///< 共享状态，为空表示不可取消
+};
+
+/// <summary>
+/// 取消源，调用Cancel后所有关联令牌都变为已取消；取消不可撤销
+/// </summary>
+class CancellationSource
+{
+public:
+    CancellationSource()
+        : m_state(std::make_shared<ST_CancellationState>())
+    {
+    }
+
+    /// <summary>
+    /// 请求取消，可由任意线程调用，重复调用无副作用
+    /// </summary>
+    void Cancel() { m_state->m_cancelled.store(true, std::memory_order_release); }
+
+    /// <summary>
+    /// 是否已请求取消
+    /// </summary>
+    bool IsCancellationRequested() const { return m_state->m_cancelled.load(std::memory_order_acquire); }
+
+    /// <summary>
+    /// 获取关联的令牌
+    /// </summary>
+    CancellationToken GetToken() const { return CancellationToken(m_state); }
+
+private:
+    std::shared_ptr<ST_CancellationState> m_state; ///< 共享状态
+};
+
+/// <summary>
+/// 带promise的任务包装，替代std::packaged_task
+/// 被调用时把结果或异常写入promise；从未被调用就销毁（任务被取消、超时跳过或被丢弃）时以TaskCancelledException完成future
+/// </summary>
+template <typename R, typename F>
+class CancellableCall
+{
+public:
+    template <typename G>
+    explicit CancellableCall(G&& func)
+        : m_func(std::forward<G>(func))
+    {
+    }
+
+    CancellableCall(CancellableCall&& other) noexcept(std::is_nothrow_move_constructible_v<F>)
+        : m_promise(std::move(other.m_promise))
+        , m_func(std::move(other.m_func))
+        , m_finished(other.m_finished)
+    {
+        other.m_finished = true;
+    }
+
+    CancellableCall& operator=(CancellableCall&&) = delete;
+    CancellableCall(const CancellableCall&) = delete;
+    CancellableCall& operator=(const CancellableCall&) = delete;
+
+    ~CancellableCall()
+    {
+        if (!m_finished)
+        {
+            m_promise.set_exception(std::make_exception_ptr(TaskCancelledException()));
+        }
+    }
+
+    /// <summary>
+    /// 获取future，只能调用一次
+    /// </summary>
+    std::future<R> GetFuture() { return m_promise.get_future(); }
+
+    /// <summary>
+    /// 执行任务并设置结果
+    /// </summary>
+    void operator()()
+    {
+        m_finished = true;
+        try
+        {
+            if constexpr (std::is_void_v<R>)
+            {
+                m_func();
+                m_promise.set_value();
+            }
+            else
+            {
+                m_promise.set_value(m_func());
+            }
+        }
+        catch (...)
+        {
+            m_promise.set_exception(std::current_exception());
+        }
+    }
+
+private:
+    std::promise<R> m_promise; ///< 结果
+    F m_func;                  ///< 任务函数
+    bool m_finished{false};    ///< 是否已设置结果（被移走的对象也视为已完成）
+};
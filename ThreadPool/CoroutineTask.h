@@ -0,0 +1,362 @@
+﻿/// <summary>
+/// 线程池协程头文件 - CoTask协程类型、TaskFuture等待体以及同步等待/分离启动
+/// </summary>
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "TaskFuture.h"
+
+template <typename T = void>
+class CoTask;
+
+/// <summary>
+/// 在线程池上恢复协程；线程池为空或投递失败时在当前线程恢复，保证协程不会被遗弃
+/// 已入队的恢复任务在线程池停止时被丢弃，此时置位cancelled后在停止线程上恢复协程
+/// </summary>
+/// <param name="pool">线程池，可为空</param>
+/// <param name="handle">协程句柄</param>
+/// <param name="cancelled">等待体中的取消标志</param>
+/// <param name="priority">恢复任务的优先级</param>
+inline void ResumeCoroutineOn(ThreadPool* pool, std::coroutine_handle<> handle, bool* cancelled, EM_TaskPriority priority = EM_TaskPriority::Normal)
+{
+    if (pool != nullptr)
+    {
+        pool->PostOrRun(ST_ResumeTask(handle, cancelled), priority);
+        return;
+    }
+    handle.resume();
+}
+
+/// <summary>
+/// CoTask承诺对象的公共部分
+/// </summary>
+class CoTaskPromiseBase
+{
+public:
+    /// <summary>
+    /// 结束时的等待体，对称转移到等待该协程的协程，没有等待者时挂起在结束点由CoTask销毁
+    /// </summary>
+    struct ST_FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            std::coroutine_handle<> continuation = handle.promise().m_continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /// <summary>
+    /// 惰性启动，协程在被co_await时才开始执行
+    /// </summary>
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    ST_FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+    /// <summary>
+    /// 设置等待者
+    /// </summary>
+    void SetContinuation(std::coroutine_handle<> continuation) noexcept { m_continuation = continuation; }
+
+protected:
+    /// <summary>
+    /// 协程抛出异常时重新抛出
+    /// </summary>
+    void RethrowIfFailed() const
+    {
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+private:
+    std::coroutine_handle<> m_continuation; ///< 等待该协程的协程
+    std::exception_ptr m_exception;         ///< 协程抛出的异常
+};
+
+/// <summary>
+/// CoTask承诺对象
+/// </summary>
+template <typename T>
+class CoTaskPromise : public CoTaskPromiseBase
+{
+public:
+    CoTask<T> get_return_object() noexcept;
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U&&, T>>>
+    void return_value(U&& value)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    /// <summary>
+    /// 取出结果，协程抛出异常时重新抛出
+    /// </summary>
+    T TakeResult()
+    {
+        RethrowIfFailed();
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value; ///< 协程返回值
+};
+
+template <>
+class CoTaskPromise<void> : public CoTaskPromiseBase
+{
+public:
+    CoTask<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void TakeResult() const { RethrowIfFailed(); }
+};
+
+/// <summary>
+/// 协程任务，惰性启动、仅可移动
+/// 在其他协程中 co_await 时开始执行，完成后直接恢复等待者（对称转移，不占用额外栈空间）；
+/// 在普通函数中用 SyncWait 阻塞获取结果，或用 ToTaskFuture/Spawn 在后台运行
+/// </summary>
+template <typename T>
+class CoTask
+{
+public:
+    using promise_type = CoTaskPromise<T>;
+    using HandleType = std::coroutine_handle<promise_type>;
+
+    CoTask() noexcept = default;
+
+    explicit CoTask(HandleType handle) noexcept
+        : m_handle(handle)
+    {
+    }
+
+    CoTask(CoTask&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    CoTask& operator=(CoTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    // 禁用拷贝构造和赋值
+    CoTask(const CoTask&) = delete;
+    CoTask& operator=(const CoTask&) = delete;
+
+    /// <summary>
+    /// 析构函数，销毁尚未启动或已完成的协程帧
+    /// </summary>
+    ~CoTask()
+    {
+        Destroy();
+    }
+
+    /// <summary>
+    /// 是否关联了协程
+    /// </summary>
+    bool IsValid() const noexcept { return static_cast<bool>(m_handle); }
+
+    /// <summary>
+    /// 协程是否已执行完毕
+    /// </summary>
+    bool IsDone() const noexcept { return m_handle && m_handle.done(); }
+
+    /// <summary>
+    /// co_await等待体：启动协程并在其完成后恢复等待者
+    /// </summary>
+    struct ST_Awaiter
+    {
+        HandleType m_handle; ///< 被等待的协程
+
+        bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            m_handle.promise().SetContinuation(awaiting);
+            return m_handle;
+        }
+
+        T await_resume()
+        {
+            if (!m_handle)
+            {
+                throw std::future_error(std::future_errc::no_state);
+            }
+            return m_handle.promise().TakeResult();
+        }
+    };
+
+    ST_Awaiter operator co_await() & noexcept { return ST_Awaiter{m_handle}; }
+
+    ST_Awaiter operator co_await() && noexcept { return ST_Awaiter{m_handle}; }
+
+private:
+    /// <summary>
+    /// 销毁协程帧
+    /// </summary>
+    void Destroy() noexcept
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+            m_handle = nullptr;
+        }
+    }
+
+private:
+    HandleType m_handle; ///< 协程句柄
+};
+
+template <typename T>
+CoTask<T> CoTaskPromise<T>::get_return_object() noexcept
+{
+    return CoTask<T>(std::coroutine_handle<CoTaskPromise<T>>::from_promise(*this));
+}
+
+inline CoTask<void> CoTaskPromise<void>::get_return_object() noexcept
+{
+    return CoTask<void>(std::coroutine_handle<CoTaskPromise<void>>::from_promise(*this));
+}
+
+/// <summary>
+/// TaskFuture等待体：future就绪后协程在其关联的线程池上恢复，等待期间不占用任何线程
+/// </summary>
+template <typename T>
+struct ST_FutureAwaiter
+{
+    TaskFuture<T> m_future;   ///< 被等待的future
+    bool m_cancelled = false; ///< 恢复任务未执行就被丢弃
+
+    bool await_ready() const { return m_future.IsReady(); }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_future.CheckValid();
+        ThreadPool* pool = m_future.m_pool;
+        bool* cancelled = &m_cancelled;
+        // 在设置结果的线程上执行续接，由续接负责把协程投递到线程池，投递失败时就地恢复
+        // 续接可能在本函数返回前就恢复协程，此后不能再访问this
+        m_future.m_state->SetContinuation([pool, handle, cancelled]() { ResumeCoroutineOn(pool, handle, cancelled); }, nullptr, EM_TaskPriority::Normal);
+    }
+
+    /// <summary>
+    /// 取出结果；恢复任务因线程池停止被丢弃时抛出TaskCancelledException
+    /// </summary>
+    T await_resume()
+    {
+        if (m_cancelled)
+        {
+            throw TaskCancelledException();
+        }
+        return m_future.Get();
+    }
+};
+
+/// <summary>
+/// 在协程中直接 co_await TaskFuture
+/// </summary>
+template <typename T>
+ST_FutureAwaiter<T> operator co_await(TaskFuture<T>&& future)
+{
+    return ST_FutureAwaiter<T>{std::move(future)};
+}
+
+/// <summary>
+/// 分离运行的协程，开始后不挂起在起点和终点，执行结束自行销毁
+/// </summary>
+struct ST_DetachedCoroutine
+{
+    struct promise_type
+    {
+        ST_DetachedCoroutine get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+/// <summary>
+/// 驱动CoTask并把结果写入promise
+/// </summary>
+template <typename T>
+ST_DetachedCoroutine RunCoTaskIntoPromise(CoTask<T> task, TaskPromise<T> promise)
+{
+    std::exception_ptr exception;
+    try
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await std::move(task);
+            promise.SetValue();
+        }
+        else
+        {
+            promise.SetValue(co_await std::move(task));
+        }
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    if (exception)
+    {
+        promise.SetException(exception);
+    }
+}
+
+/// <summary>
+/// 立即在当前线程启动协程（直到其第一次挂起），返回完成时就绪的future
+/// </summary>
+/// <param name="task">协程任务</param>
+/// <param name="pool">future续接投递的线程池，可为空</param>
+/// <returns>协程结果的future</returns>
+template <typename T>
+TaskFuture<T> ToTaskFuture(CoTask<T> task, ThreadPool* pool = nullptr)
+{
+    TaskPromise<T> promise(pool);
+    TaskFuture<T> future = promise.GetFuture();
+    RunCoTaskIntoPromise(std::move(task), std::move(promise));
+    return future;
+}
+
+/// <summary>
+/// 分离启动协程，不关心结果；协程抛出的异常被丢弃
+/// 通常协程体以 co_await pool.Schedule() 开始，使其立即转到线程池执行
+/// </summary>
+/// <param name="task">协程任务</param>
+template <typename T>
+void Spawn(CoTask<T> task)
+{
+    ToTaskFuture(std::move(task));
+}
+
+/// <summary>
+/// 在普通函数中阻塞等待协程完成并返回结果，不能在线程池工作线程上对依赖该线程池的协程调用
+/// </summary>
+/// <param name="task">协程任务</param>
+/// <returns>协程结果</returns>
+template <typename T>
+T SyncWait(CoTask<T> task)
+{
+    return ToTaskFuture(std::move(task)).Get();
+}
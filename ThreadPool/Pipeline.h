@@ -0,0 +1,703 @@
+﻿/// <summary>
+/// 流水线头文件 - 在线程池上运行的多阶段有界流水线，用于解码、滤镜、编码等按顺序处理的数据流
+/// </summary>
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+/// <summary>
+/// 流水线阶段统计
+/// </summary>
+struct ST_PipelineStageStats
+{
+    std::string m_name;         ///< 阶段名称
+    size_t m_parallelism{0};    ///< 最大并行度
+    size_t m_capacity{0};       ///< 容量（排队与处理中的数据项合计上限）
+    size_t m_queued{0};         ///< 排队中的数据项数
+    size_t m_running{0};        ///< 正在运行的执行任务数
+    uint64_t m_processed{0};    ///< 已处理的数据项数
+    uint64_t m_dropped{0};      ///< 被过滤、处理失败或流水线失败后跳过的数据项数
+};
+
+/// <summary>
+/// 有界流水线
+/// 数据项按Push顺序编号后依次经过各阶段，最后交给输出函数。每个阶段有最大并行度与容量：
+/// 阶段只有在下游还有空位时才取出下一个数据项，下游已满时暂停并在下游腾出空位后恢复，
+/// 第一个阶段已满时Push阻塞，因此任意时刻缓存的数据项数有上限，慢阶段自然向上游施加背压。
+/// 阶段在线程池上以批量执行任务的形式运行，不占用专门的线程；启用顺序恢复时输出函数按Push顺序接收数据项。
+/// 任一阶段或输出函数抛出异常后流水线进入失败状态：之后的数据项不再处理，Push返回false，Wait重新抛出该异常
+/// </summary>
+/// <typeparam name="T">数据项类型，需可移动构造</typeparam>
+template <typename T>
+class Pipeline
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="pool">执行各阶段的线程池，需比流水线存活更久</param>
+    /// <param name="priority">阶段执行任务在线程池中的优先级</param>
+    explicit Pipeline(ThreadPool& pool, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        : m_pool(pool)
+        , m_priority(priority)
+        , m_waiter(pool)
+    {
+    }
+
+    /// <summary>
+    /// 析构函数，关闭输入并等待已推入的数据项处理完毕，不抛出异常
+    /// </summary>
+    ~Pipeline()
+    {
+        Close();
+        WaitUntil([this]() { return m_inFlight.load(std::memory_order_acquire) == 0 && m_activeTasks.load(std::memory_order_acquire) == 0; });
+    }
+
+    // 禁用拷贝构造和赋值
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /// <summary>
+    /// 追加处理阶段，需在第一次Push之前调用
+    /// 阶段函数以T&amp;调用，可就地修改数据项；返回bool时返回false表示丢弃该数据项。并行度大于1时阶段函数会被并发调用
+    /// </summary>
+    /// <param name="name">阶段名称，用于统计</param>
+    /// <param name="func">阶段函数</param>
+    /// <param name="parallelism">最大并行度，0按1处理</param>
+    /// <param name="capacity">容量，为0时取并行度的2倍</param>
+    /// <returns>流水线自身，便于链式调用</returns>
+    template <typename F>
+    Pipeline& AddStage(std::string name, F&& func, size_t parallelism = 1, size_t capacity = 0)
+    {
+        if (m_started.load(std::memory_order_acquire))
+        {
+            throw std::logic_error("Pipeline stages must be added before the first Push");
+        }
+
+        auto stage = std::make_unique<ST_Stage>();
+        stage->m_name = std::move(name);
+        stage->m_parallelism = (std::max)(parallelism, static_cast<size_t>(1));
+        stage->m_capacity = capacity > 0 ? capacity : stage->m_parallelism * 2;
+        if constexpr (std::is_same_v<std::invoke_result_t<std::decay_t<F>&, T&>, bool>)
+        {
+            stage->m_func = std::forward<F>(func);
+        }
+        else
+        {
+            stage->m_func = [inner = std::decay_t<F>(std::forward<F>(func))](T& item) mutable
+            {
+                inner(item);
+                return true;
+            };
+        }
+        m_stages.push_back(std::move(stage));
+        return *this;
+    }
+
+    /// <summary>
+    /// 设置输出函数，需在第一次Push之前调用；输出函数同一时刻只在一个线程上调用，接收数据项的右值
+    /// </summary>
+    /// <param name="sink">输出函数</param>
+    /// <param name="ordered">是否按Push顺序输出；为false时按完成顺序输出</param>
+    /// <returns>流水线自身，便于链式调用</returns>
+    template <typename F>
+    Pipeline& SetSink(F&& sink, bool ordered = true)
+    {
+        if (m_started.load(std::memory_order_acquire))
+        {
+            throw std::logic_error("Pipeline sink must be set before the first Push");
+        }
+
+        m_sink = std::forward<F>(sink);
+        m_ordered = ordered;
+        return *this;
+    }
+
+    /// <summary>
+    /// 设置流水线中同时存在的数据项数上限（包括等待顺序恢复的数据项），需在第一次Push之前调用
+    /// </summary>
+    /// <param name="maxInFlight">上限，为0时取各阶段容量之和</param>
+    /// <returns>流水线自身，便于链式调用</returns>
+    Pipeline& SetMaxInFlight(size_t maxInFlight)
+    {
+        if (m_started.load(std::memory_order_acquire))
+        {
+            throw std::logic_error("Pipeline window must be set before the first Push");
+        }
+
+        m_maxInFlight = maxInFlight;
+        return *this;
+    }
+
+    /// <summary>
+    /// 推入数据项，第一个阶段已满或达到数据项上限时阻塞等待（等待期间协助执行线程池任务）
+    /// </summary>
+    /// <param name="item">数据项</param>
+    /// <returns>是否推入成功，流水线已关闭或已失败时返回false</returns>
+    bool Push(T item)
+    {
+        Start();
+        ST_Stage& first = *m_stages.front();
+        while (true)
+        {
+            if (m_closed.load(std::memory_order_acquire) || m_failed.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (TryAdmit(item))
+            {
+                return true;
+            }
+
+            WaitUntil([this, &first]()
+            {
+                return m_closed.load(std::memory_order_acquire) || m_failed.load(std::memory_order_acquire)
+                    || (first.m_occupied.load(std::memory_order_acquire) < first.m_capacity
+                        && m_inFlight.load(std::memory_order_acquire) < m_maxInFlight);
+            });
+        }
+    }
+
+    /// <summary>
+    /// 尝试推入数据项，不等待
+    /// </summary>
+    /// <param name="item">数据项，推入失败时保持不变</param>
+    /// <returns>是否推入成功</returns>
+    bool TryPush(T& item)
+    {
+        Start();
+        if (m_closed.load(std::memory_order_acquire) || m_failed.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        return TryAdmit(item);
+    }
+
+    /// <summary>
+    /// 关闭输入，之后Push返回false；已推入的数据项继续处理
+    /// </summary>
+    void Close()
+    {
+        m_closed.store(true, std::memory_order_release);
+        NotifyWaiters();
+    }
+
+    /// <summary>
+    /// 等待已推入的数据项全部输出或丢弃，流水线失败时重新抛出第一个异常
+    /// </summary>
+    void Wait()
+    {
+        WaitUntil([this]() { return m_inFlight.load(std::memory_order_acquire) == 0; });
+
+        std::lock_guard<std::mutex> lock(m_waiter.GetMutex());
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+    }
+
+    /// <summary>
+    /// 获取已交给输出函数的数据项数
+    /// </summary>
+    uint64_t GetDeliveredCount() const { return m_delivered.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 获取流水线中尚未输出或丢弃的数据项数
+    /// </summary>
+    size_t GetInFlightCount() const { return m_inFlight.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 获取各阶段统计，用于定位瓶颈阶段（排队数持续接近容量的阶段）
+    /// </summary>
+    std::vector<ST_PipelineStageStats> GetStageStats() const
+    {
+        std::vector<ST_PipelineStageStats> result;
+        result.reserve(m_stages.size());
+        for (const auto& stage : m_stages)
+        {
+            ST_PipelineStageStats stats;
+            stats.m_name = stage->m_name;
+            stats.m_parallelism = stage->m_parallelism;
+            stats.m_capacity = stage->m_capacity;
+            {
+                std::lock_guard<std::mutex> lock(stage->m_mutex);
+                stats.m_queued = stage->m_queue.size();
+                stats.m_running = stage->m_running;
+            }
+            stats.m_processed = stage->m_processed.load(std::memory_order_relaxed);
+            stats.m_dropped = stage->m_dropped.load(std::memory_order_relaxed);
+            result.push_back(std::move(stats));
+        }
+        return result;
+    }
+
+private:
+    /// <summary>
+    /// 带序号的数据项
+    /// </summary>
+    struct ST_Item
+    {
+        uint64_t m_sequence; ///< Push顺序编号
+        T m_value;           ///< 数据
+    };
+
+    /// <summary>
+    /// 处理阶段；m_occupied统计排队、处理中以及上游为转交而预留的数据项，不超过容量
+    /// </summary>
+    struct ST_Stage
+    {
+        std::string m_name;                       ///< 阶段名称
+        std::function<bool(T&)> m_func;          ///< 阶段函数
+        size_t m_parallelism{1};                  ///< 最大并行度
+        size_t m_capacity{2};                     ///< 容量
+        mutable std::mutex m_mutex;               ///< 保护队列、运行数与上游暂停标志
+        std::deque<ST_Item> m_queue;              ///< 排队中的数据项
+        size_t m_running{0};                      ///< 正在运行的执行任务数
+        bool m_upstreamStalled{false};            ///< 上游因本阶段已满而暂停
+        std::atomic<size_t> m_occupied{0};        ///< 已占用的容量，只在m_mutex内修改
+        std::atomic<uint64_t> m_processed{0};     ///< 已处理的数据项数
+        std::atomic<uint64_t> m_dropped{0};       ///< 跳过的数据项数
+    };
+
+    /// <summary>
+    /// 阶段执行任务；从未执行就被销毁（线程池停止时丢弃）时放弃该阶段排队的数据项，保证等待者能够返回
+    /// </summary>
+    struct ST_DrainTask
+    {
+        Pipeline* m_pipeline; ///< 所属流水线，为空表示已执行或已移走
+        size_t m_stage;       ///< 阶段下标
+
+        ST_DrainTask(Pipeline* pipeline, size_t stage)
+            : m_pipeline(pipeline)
+            , m_stage(stage)
+        {
+        }
+
+        ST_DrainTask(ST_DrainTask&& other) noexcept
+            : m_pipeline(std::exchange(other.m_pipeline, nullptr))
+            , m_stage(other.m_stage)
+        {
+        }
+
+        ST_DrainTask(const ST_DrainTask&) = delete;
+        ST_DrainTask& operator=(const ST_DrainTask&) = delete;
+        ST_DrainTask& operator=(ST_DrainTask&&) = delete;
+
+        ~ST_DrainTask()
+        {
+            if (Pipeline* pipeline = std::exchange(m_pipeline, nullptr))
+            {
+                pipeline->Abandon(m_stage);
+                pipeline->FinishTask();
+            }
+        }
+
+        void operator()()
+        {
+            Pipeline* pipeline = std::exchange(m_pipeline, nullptr);
+            pipeline->Drain(m_stage);
+            pipeline->FinishTask();
+        }
+    };
+
+    static constexpr size_t DRAIN_BATCH_SIZE = 16; ///< 每个执行任务最多连续处理的数据项数，之后重新入队让出工作线程
+
+    /// <summary>
+    /// 第一次推入时冻结配置
+    /// </summary>
+    void Start()
+    {
+        std::call_once(m_startOnce, [this]()
+        {
+            if (m_stages.empty())
+            {
+                throw std::logic_error("Pipeline has no stages");
+            }
+            if (m_maxInFlight == 0)
+            {
+                for (const auto& stage : m_stages)
+                {
+                    m_maxInFlight += stage->m_capacity;
+                }
+            }
+            m_started.store(true, std::memory_order_release);
+        });
+    }
+
+    /// <summary>
+    /// 第一个阶段与数据项上限都有空位时编号并放入第一个阶段，编号与入队在同一把锁内完成，保证顺序一致
+    /// </summary>
+    bool TryAdmit(T& item)
+    {
+        ST_Stage& first = *m_stages.front();
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(first.m_mutex);
+            if (first.m_occupied.load(std::memory_order_relaxed) >= first.m_capacity
+                || m_inFlight.load(std::memory_order_relaxed) >= m_maxInFlight)
+            {
+                return false;
+            }
+            first.m_occupied.fetch_add(1, std::memory_order_relaxed);
+            m_inFlight.fetch_add(1, std::memory_order_relaxed);
+            first.m_queue.push_back(ST_Item{ m_nextSequence++, std::move(item) });
+            if (first.m_running < first.m_parallelism)
+            {
+                ++first.m_running;
+                schedule = true;
+            }
+        }
+        if (schedule)
+        {
+            PostDrain(0);
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// 把已预留容量的数据项放入阶段队列，运行数未达并行度时投递执行任务
+    /// </summary>
+    void Enqueue(size_t index, ST_Item&& item)
+    {
+        ST_Stage& stage = *m_stages[index];
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(stage.m_mutex);
+            stage.m_queue.push_back(std::move(item));
+            if (stage.m_running < stage.m_parallelism)
+            {
+                ++stage.m_running;
+                schedule = true;
+            }
+        }
+        if (schedule)
+        {
+            PostDrain(index);
+        }
+    }
+
+    /// <summary>
+    /// 阶段有排队数据项且运行数未达并行度时投递执行任务，用于下游腾出空位后恢复暂停的阶段
+    /// </summary>
+    void Reschedule(size_t index)
+    {
+        ST_Stage& stage = *m_stages[index];
+        {
+            std::lock_guard<std::mutex> lock(stage.m_mutex);
+            if (stage.m_queue.empty() || stage.m_running >= stage.m_parallelism)
+            {
+                return;
+            }
+            ++stage.m_running;
+        }
+        PostDrain(index);
+    }
+
+    /// <summary>
+    /// 为转交数据项预留下游容量；已满时标记上游暂停，由下游腾出空位时恢复
+    /// </summary>
+    bool TryReserve(size_t index)
+    {
+        ST_Stage& stage = *m_stages[index];
+        std::lock_guard<std::mutex> lock(stage.m_mutex);
+        if (stage.m_occupied.load(std::memory_order_relaxed) >= stage.m_capacity)
+        {
+            stage.m_upstreamStalled = true;
+            return false;
+        }
+        stage.m_occupied.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// <summary>
+    /// 归还阶段的一个容量，恢复暂停的上游；第一个阶段有空位时唤醒等待中的Push
+    /// </summary>
+    void Release(size_t index)
+    {
+        ST_Stage& stage = *m_stages[index];
+        bool resumeUpstream = false;
+        {
+            std::lock_guard<std::mutex> lock(stage.m_mutex);
+            stage.m_occupied.fetch_sub(1, std::memory_order_relaxed);
+            resumeUpstream = std::exchange(stage.m_upstreamStalled, false);
+        }
+        if (index == 0)
+        {
+            NotifyWaiters();
+        }
+        else if (resumeUpstream)
+        {
+            Reschedule(index - 1);
+        }
+    }
+
+    /// <summary>
+    /// 投递阶段执行任务；线程池队列已满或已停止时就地执行
+    /// </summary>
+    void PostDrain(size_t index)
+    {
+        m_activeTasks.fetch_add(1, std::memory_order_relaxed);
+        m_pool.PostOrRun(ST_DrainTask(this, index), m_priority);
+    }
+
+    /// <summary>
+    /// 阶段执行任务主体：先预留下游容量再取出数据项，保证转交时下游一定有空位
+    /// </summary>
+    void Drain(size_t index)
+    {
+        ST_Stage& stage = *m_stages[index];
+        bool last = index + 1 == m_stages.size();
+
+        for (size_t count = 0; ; ++count)
+        {
+            if (count == DRAIN_BATCH_SIZE)
+            {
+                // 运行数保持不变，由新投递的任务继续
+                PostDrain(index);
+                return;
+            }
+
+            if (!last && !TryReserve(index + 1))
+            {
+                {
+                    std::lock_guard<std::mutex> lock(stage.m_mutex);
+                    --stage.m_running;
+                }
+                // 下游可能在预留失败与运行数递减之间腾出空位，此时它的恢复请求被忽略，这里补做一次
+                if (m_stages[index + 1]->m_occupied.load(std::memory_order_acquire) < m_stages[index + 1]->m_capacity)
+                {
+                    Reschedule(index);
+                }
+                return;
+            }
+
+            std::optional<ST_Item> item;
+            {
+                std::lock_guard<std::mutex> lock(stage.m_mutex);
+                if (stage.m_queue.empty())
+                {
+                    --stage.m_running;
+                }
+                else
+                {
+                    item.emplace(std::move(stage.m_queue.front()));
+                    stage.m_queue.pop_front();
+                }
+            }
+            if (!item)
+            {
+                if (!last)
+                {
+                    Release(index + 1);
+                }
+                return;
+            }
+
+            bool keep = !m_failed.load(std::memory_order_acquire);
+            if (keep)
+            {
+                try
+                {
+                    keep = stage.m_func(item->m_value);
+                }
+                catch (...)
+                {
+                    Fail(std::current_exception());
+                    keep = false;
+                }
+            }
+            (keep ? stage.m_processed : stage.m_dropped).fetch_add(1, std::memory_order_relaxed);
+
+            if (keep && !last)
+            {
+                Enqueue(index + 1, std::move(*item));
+            }
+            else
+            {
+                if (!last)
+                {
+                    Release(index + 1);
+                }
+                std::optional<T> value;
+                if (keep)
+                {
+                    value.emplace(std::move(item->m_value));
+                }
+                Deliver(item->m_sequence, std::move(value));
+            }
+            item.reset();
+            Release(index);
+        }
+    }
+
+    /// <summary>
+    /// 执行任务被线程池丢弃：流水线进入失败状态，该阶段排队的数据项按丢弃处理
+    /// </summary>
+    void Abandon(size_t index)
+    {
+        Fail(std::make_exception_ptr(std::runtime_error("ThreadPool is stopped")));
+
+        ST_Stage& stage = *m_stages[index];
+        std::deque<ST_Item> abandoned;
+        {
+            std::lock_guard<std::mutex> lock(stage.m_mutex);
+            --stage.m_running;
+            abandoned.swap(stage.m_queue);
+        }
+        for (ST_Item& item : abandoned)
+        {
+            stage.m_dropped.fetch_add(1, std::memory_order_relaxed);
+            Deliver(item.m_sequence, std::nullopt);
+            Release(index);
+        }
+    }
+
+    /// <summary>
+    /// 数据项到达输出端：按顺序或按完成顺序交给输出函数，同一时刻只有一个线程调用输出函数；
+    /// value为空表示数据项已被丢弃，只用于推进顺序
+    /// </summary>
+    void Deliver(uint64_t sequence, std::optional<T>&& value)
+    {
+        std::unique_lock<std::mutex> lock(m_sinkMutex);
+        if (m_ordered)
+        {
+            m_reorderBuffer.emplace(sequence, std::move(value));
+        }
+        else
+        {
+            m_completed.push_back(std::move(value));
+        }
+        if (m_sinkBusy)
+        {
+            // 正在输出的线程会继续处理刚放入的数据项
+            return;
+        }
+
+        m_sinkBusy = true;
+        while (true)
+        {
+            std::optional<T> next;
+            if (m_ordered)
+            {
+                auto it = m_reorderBuffer.find(m_nextDelivery);
+                if (it == m_reorderBuffer.end())
+                {
+                    break;
+                }
+                next = std::move(it->second);
+                m_reorderBuffer.erase(it);
+                ++m_nextDelivery;
+            }
+            else
+            {
+                if (m_completed.empty())
+                {
+                    break;
+                }
+                next = std::move(m_completed.front());
+                m_completed.pop_front();
+            }
+            lock.unlock();
+
+            if (next && m_sink && !m_failed.load(std::memory_order_acquire))
+            {
+                try
+                {
+                    m_sink(std::move(*next));
+                    m_delivered.fetch_add(1, std::memory_order_relaxed);
+                }
+                catch (...)
+                {
+                    Fail(std::current_exception());
+                }
+            }
+            next.reset();
+
+            m_inFlight.fetch_sub(1, std::memory_order_acq_rel);
+            NotifyWaiters();
+            lock.lock();
+        }
+        m_sinkBusy = false;
+    }
+
+    /// <summary>
+    /// 记录第一个异常并进入失败状态
+    /// </summary>
+    void Fail(std::exception_ptr exception)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_waiter.GetMutex());
+            if (!m_exception)
+            {
+                m_exception = std::move(exception);
+            }
+        }
+        m_failed.store(true, std::memory_order_release);
+        NotifyWaiters();
+    }
+
+    /// <summary>
+    /// 一个执行任务结束；计数递减在互斥锁内完成，析构函数返回时不会再有执行任务访问流水线
+    /// </summary>
+    void FinishTask()
+    {
+        std::lock_guard<std::mutex> lock(m_waiter.GetMutex());
+        m_activeTasks.fetch_sub(1, std::memory_order_acq_rel);
+        m_waiter.NotifyAll();
+    }
+
+    /// <summary>
+    /// 唤醒等待空位或等待完成的线程
+    /// </summary>
+    void NotifyWaiters()
+    {
+        std::lock_guard<std::mutex> lock(m_waiter.GetMutex());
+        m_waiter.NotifyAll();
+    }
+
+    /// <summary>
+    /// 等待条件成立，等待期间协助执行线程池任务；工作线程上等待时休眠到有执行任务结束或新任务提交
+    /// </summary>
+    template <typename Predicate>
+    void WaitUntil(Predicate predicate)
+    {
+        m_waiter.Wait(predicate);
+    }
+
+private:
+    ThreadPool& m_pool;                                 ///< 线程池
+    EM_TaskPriority m_priority;                         ///< 阶段执行任务的优先级
+    std::vector<std::unique_ptr<ST_Stage>> m_stages;    ///< 各阶段，启动后不再改变
+    std::function<void(T&&)> m_sink;                    ///< 输出函数，可为空
+    bool m_ordered{true};                               ///< 是否按Push顺序输出
+    size_t m_maxInFlight{0};                            ///< 同时存在的数据项数上限
+    std::once_flag m_startOnce;                         ///< 启动标志
+    std::atomic<bool> m_started{false};                 ///< 是否已启动
+    std::atomic<bool> m_closed{false};                  ///< 是否已关闭输入
+    std::atomic<bool> m_failed{false};                  ///< 是否已失败
+    std::exception_ptr m_exception;                     ///< 第一个异常（受m_waiter的互斥锁保护）
+    uint64_t m_nextSequence{0};                         ///< 下一个数据项编号（受第一个阶段的互斥锁保护）
+    std::atomic<size_t> m_inFlight{0};                  ///< 已推入但尚未输出或丢弃的数据项数
+    std::atomic<size_t> m_activeTasks{0};               ///< 已投递但尚未结束的执行任务数
+    std::atomic<uint64_t> m_delivered{0};               ///< 已输出的数据项数
+    std::mutex m_sinkMutex;                             ///< 输出端互斥锁
+    bool m_sinkBusy{false};                             ///< 是否有线程正在调用输出函数（受m_sinkMutex保护）
+    uint64_t m_nextDelivery{0};                         ///< 下一个应输出的编号（受m_sinkMutex保护）
+    std::map<uint64_t, std::optional<T>> m_reorderBuffer; ///< 等待顺序恢复的数据项（受m_sinkMutex保护）
+    std::deque<std::optional<T>> m_completed;           ///< 按完成顺序等待输出的数据项（受m_sinkMutex保护）
+    HelpingWaiter m_waiter;                             ///< 空位、完成与失败通知
+};
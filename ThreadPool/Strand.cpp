@@ -0,0 +1,177 @@
+﻿/// <summary>
+/// 串行执行器实现文件
+/// </summary>
+#include "Strand.h"
+
+namespace
+{
+    constexpr size_t DRAIN_BATCH_SIZE = 64; ///< 每批最多连续执行的任务数，之后重新入队让出工作线程
+
+    thread_local const void* t_currentStrand = nullptr; ///< 当前线程正在执行的Strand状态
+    thread_local bool t_resumeInline = false;          ///< 续批任务在执行中的Strand内被就地执行时置位，由外层继续循环
+}
+
+/// <summary>
+/// Strand共享状态：无锁多生产者单消费者队列与未完成任务计数
+/// 计数由0变为1的提交者负责投递批量执行任务，因此同一时刻最多只有一个消费者
+/// </summary>
+struct Strand::ST_StrandState : std::enable_shared_from_this<Strand::ST_StrandState>
+{
+    ThreadPool& m_pool;                 ///< 执行任务的线程池
+    EM_TaskPriority m_priority;         ///< 批量执行任务的优先级
+    MpscTaskQueue m_queue;              ///< 待执行任务，线程池停止时未执行的任务随状态一起销毁
+    std::atomic<size_t> m_pending{0};   ///< 已入队但未执行完毕的任务数
+
+    /// <summary>
+    /// 批量执行任务；未执行就被线程池丢弃时（线程池停止时清空队列）在析构中重新投递，线程池已停止时随之就地执行，
+    /// 保证未完成计数最终归零，否则之后的提交都看不到计数由0变为1，Strand中的任务永远不会再执行
+    /// </summary>
+    struct ST_DrainTask
+    {
+        std::shared_ptr<ST_StrandState> m_state; ///< 共享状态，为空表示已执行或已移走
+
+        explicit ST_DrainTask(std::shared_ptr<ST_StrandState> state)
+            : m_state(std::move(state))
+        {
+        }
+
+        ST_DrainTask(ST_DrainTask&&) noexcept = default;
+        ST_DrainTask(const ST_DrainTask&) = delete;
+        ST_DrainTask& operator=(const ST_DrainTask&) = delete;
+        ST_DrainTask& operator=(ST_DrainTask&&) = delete;
+
+        ~ST_DrainTask()
+        {
+            if (std::shared_ptr<ST_StrandState> state = std::move(m_state))
+            {
+                state->Schedule();
+            }
+        }
+
+        void operator()()
+        {
+            std::shared_ptr<ST_StrandState> state = std::move(m_state);
+            if (t_currentStrand == state.get())
+            {
+                // 在本Strand的执行循环中被就地执行（线程池队列已满），交给外层循环继续，避免递归
+                t_resumeInline = true;
+                return;
+            }
+            state->Drain();
+        }
+    };
+
+    ST_StrandState(ThreadPool& pool, EM_TaskPriority priority)
+        : m_pool(pool)
+        , m_priority(priority)
+    {
+    }
+
+    /// <summary>
+    /// 投递批量执行任务；线程池已停止或队列已满时就地执行
+    /// </summary>
+    void Schedule()
+    {
+        m_pool.PostOrRun(ST_DrainTask(shared_from_this()), m_priority);
+    }
+
+    /// <summary>
+    /// 按顺序执行任务，队列为空时结束；每批执行完后若仍有任务则重新投递
+    /// </summary>
+    void Drain()
+    {
+        const void* previousStrand = t_currentStrand;
+        t_currentStrand = this;
+
+        while (true)
+        {
+            bool drained = false;
+            for (size_t i = 0; i < DRAIN_BATCH_SIZE; ++i)
+            {
+                TaskFunction func;
+                while (!m_queue.try_pop(func))
+                {
+                    // 计数已包含该任务但生产者尚未完成链接，等待其完成
+                    std::this_thread::yield();
+                }
+
+                try
+                {
+                    func();
+                }
+                catch (...) {}
+                func = nullptr; // 在计数归零前释放任务捕获的资源
+
+                if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    drained = true;
+                    break;
+                }
+            }
+
+            if (drained)
+            {
+                break;
+            }
+
+            t_resumeInline = false;
+            Schedule();
+            if (!t_resumeInline)
+            {
+                // 已投递到线程池，由其他工作线程继续；此后不能再访问队列
+                break;
+            }
+        }
+
+        t_currentStrand = previousStrand;
+    }
+};
+
+Strand::Strand(ThreadPool& pool, EM_TaskPriority priority)
+    : m_state(std::make_shared<ST_StrandState>(pool, priority))
+{
+}
+
+Strand::~Strand() = default;
+
+bool Strand::IsRunningInThisThread() const
+{
+    return t_currentStrand == m_state.get();
+}
+
+size_t Strand::GetPendingCount() const
+{
+    return m_state->m_pending.load(std::memory_order_acquire);
+}
+
+void Strand::Enqueue(TaskFunction&& func)
+{
+    m_state->m_queue.push(std::move(func));
+    if (m_state->m_pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+    {
+        m_state->Schedule();
+    }
+}
+
+SerialExecutor::SerialExecutor(ThreadPool& pool, size_t stripeCount, EM_TaskPriority priority)
+{
+    if (stripeCount == 0)
+    {
+        stripeCount = (std::max)(std::thread::hardware_concurrency(), 1u) * 4;
+    }
+
+    m_strands.reserve(stripeCount);
+    for (size_t i = 0; i < stripeCount; ++i)
+    {
+        m_strands.push_back(std::make_unique<Strand>(pool, priority));
+    }
+}
+
+size_t SerialExecutor::StripeIndex(size_t hash) const
+{
+    uint64_t mixed = static_cast<uint64_t>(hash);
+    mixed ^= mixed >> 33;
+    mixed *= 0xff51afd7ed558ccdULL;
+    mixed ^= mixed >> 33;
+    return static_cast<size_t>(mixed % m_strands.size());
+}
@@ -0,0 +1,154 @@
+﻿/// <summary>
+/// 串行执行器头文件 - 在线程池上按提交顺序逐个执行同一顺序域的任务
+/// </summary>
+#pragma once
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ThreadPool.h"
+
+/// <summary>
+/// 串行执行器（Strand）
+/// 通过同一个Strand提交的任务按提交顺序执行，任意时刻最多只有一个在运行；不同Strand之间并行执行。
+/// 提交端是无锁的多生产者队列，只有队列由空变为非空时才向线程池投递一次批量执行任务；
+/// 执行端每批最多连续执行固定数量的任务后重新入队，让出工作线程，工作线程上不需要任何锁。
+/// Strand对象析构后已提交的任务仍会执行；线程池停止时尚未执行的任务在停止线程池的线程上执行完毕
+/// </summary>
+class SDK_API Strand
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="pool">执行任务的线程池，需比已提交的任务存活更久</param>
+    /// <param name="priority">批量执行任务在线程池中的优先级</param>
+    explicit Strand(ThreadPool& pool, EM_TaskPriority priority = EM_TaskPriority::Normal);
+
+    /// <summary>
+    /// 析构函数，不等待已提交的任务
+    /// </summary>
+    ~Strand();
+
+    // 禁用拷贝构造和赋值
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+
+    /// <summary>
+    /// 提交无需返回值的任务，任务抛出的异常被忽略
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    template <typename F>
+    void Post(F&& f)
+    {
+        Enqueue(TaskFunction(std::forward<F>(f)));
+    }
+
+    /// <summary>
+    /// 提交任务
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <returns>future对象，用于获取任务结果</returns>
+    template <typename F>
+    auto Submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>&>>
+    {
+        using ResultType = std::invoke_result_t<std::decay_t<F>&>;
+
+        CancellableCall<ResultType, std::decay_t<F>> call(std::forward<F>(f));
+        std::future<ResultType> result = call.GetFuture();
+        Enqueue(TaskFunction(std::move(call)));
+        return result;
+    }
+
+    /// <summary>
+    /// 当前线程是否正在执行本Strand的任务
+    /// </summary>
+    bool IsRunningInThisThread() const;
+
+    /// <summary>
+    /// 获取已提交但尚未执行完毕的任务数
+    /// </summary>
+    size_t GetPendingCount() const;
+
+private:
+    struct ST_StrandState;
+
+    /// <summary>
+    /// 任务入队，队列由空变为非空时投递批量执行任务
+    /// </summary>
+    /// <param name="func">任务函数</param>
+    void Enqueue(TaskFunction&& func);
+
+private:
+    std::shared_ptr<ST_StrandState> m_state; ///< 共享状态，批量执行任务持有引用，Strand析构后仍可执行完剩余任务
+};
+
+/// <summary>
+/// 按键划分顺序域的串行执行器
+/// 键经哈希映射到固定数量的Strand：相同键的任务严格按提交顺序串行执行，不同键大多并行执行（哈希冲突的键之间也会串行）。
+/// 提交时只做一次哈希与取模，不加锁，也不会为每个键保留状态
+/// </summary>
+class SDK_API SerialExecutor
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="pool">执行任务的线程池</param>
+    /// <param name="stripeCount">Strand数量，为0时取硬件线程数的4倍</param>
+    /// <param name="priority">任务在线程池中的优先级</param>
+    explicit SerialExecutor(ThreadPool& pool, size_t stripeCount = 0, EM_TaskPriority priority = EM_TaskPriority::Normal);
+
+    // 禁用拷贝构造和赋值
+    SerialExecutor(const SerialExecutor&) = delete;
+    SerialExecutor& operator=(const SerialExecutor&) = delete;
+
+    /// <summary>
+    /// 在键对应的顺序域中提交无需返回值的任务
+    /// </summary>
+    /// <param name="key">顺序域键，需可用std::hash计算哈希</param>
+    /// <param name="f">任务函数</param>
+    template <typename Key, typename F>
+    void Post(const Key& key, F&& f)
+    {
+        GetStrand(key).Post(std::forward<F>(f));
+    }
+
+    /// <summary>
+    /// 在键对应的顺序域中提交任务
+    /// </summary>
+    /// <param name="key">顺序域键</param>
+    /// <param name="f">任务函数</param>
+    /// <returns>future对象，用于获取任务结果</returns>
+    template <typename Key, typename F>
+    auto Submit(const Key& key, F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>&>>
+    {
+        return GetStrand(key).Submit(std::forward<F>(f));
+    }
+
+    /// <summary>
+    /// 获取键对应的Strand
+    /// </summary>
+    /// <param name="key">顺序域键</param>
+    template <typename Key>
+    Strand& GetStrand(const Key& key)
+    {
+        return *m_strands[StripeIndex(std::hash<Key>()(key))];
+    }
+
+    /// <summary>
+    /// 获取Strand数量
+    /// </summary>
+    size_t GetStripeCount() const { return m_strands.size(); }
+
+private:
+    /// <summary>
+    /// 哈希值映射到Strand下标，先混合高位，避免整数键的恒等哈希集中在少数Strand上
+    /// </summary>
+    size_t StripeIndex(size_t hash) const;
+
+private:
+    std::vector<std::unique_ptr<Strand>> m_strands; ///< 各顺序域
+};
@@ -0,0 +1,180 @@
+﻿/// <summary>
+/// 线程池任务函数实现文件 - 任务内存块池
+/// </summary>
+#include "TaskFunction.h"
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    constexpr size_t SIZE_CLASS_COUNT = 4;   ///< 大小分级数量：128/256/512/1024字节
+    constexpr size_t MIN_BLOCK_SIZE = 128;   ///< 最小块大小
+    constexpr size_t BATCH_SIZE = 32;        ///< 本地缓存与全局仓库之间的批量交换数量
+
+    /// <summary>
+    /// 空闲块链表节点，复用空闲块自身的内存
+    /// </summary>
+    struct ST_FreeBlock
+    {
+        ST_FreeBlock* m_next; ///< 下一个空闲块
+    };
+
+    /// <summary>
+    /// 空闲块链表
+    /// </summary>
+    struct ST_FreeList
+    {
+        ST_FreeBlock* m_head{nullptr}; ///< 链表头
+        size_t m_count{0};             ///< 块数量
+    };
+
+    /// <summary>
+    /// 全局仓库，按大小分级保存成批的空闲块
+    /// </summary>
+    struct ST_BlockDepot
+    {
+        std::mutex m_mutex;                                           ///< 仓库互斥锁
+        std::array<std::vector<ST_FreeList>, SIZE_CLASS_COUNT> m_batches; ///< 各分级的空闲批次
+    };
+
+    /// <summary>
+    /// 获取全局仓库，有意不释放，保证线程退出时本地缓存仍可归还
+    /// </summary>
+    ST_BlockDepot& GetDepot()
+    {
+        static ST_BlockDepot* depot = new ST_BlockDepot();
+        return *depot;
+    }
+
+    /// <summary>
+    /// 计算大小分级
+    /// </summary>
+    size_t SizeClassIndex(size_t size)
+    {
+        size_t index = 0;
+        size_t blockSize = MIN_BLOCK_SIZE;
+        while (blockSize < size)
+        {
+            blockSize <<= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    /// <summary>
+    /// 计算分级对应的块大小
+    /// </summary>
+    size_t SizeClassBytes(size_t index)
+    {
+        return MIN_BLOCK_SIZE << index;
+    }
+
+    /// <summary>
+    /// 线程本地缓存
+    /// </summary>
+    struct ST_ThreadBlockCache
+    {
+        std::array<ST_FreeList, SIZE_CLASS_COUNT> m_lists; ///< 各分级的本地空闲链表
+
+        ~ST_ThreadBlockCache()
+        {
+            ST_BlockDepot& depot = GetDepot();
+            std::lock_guard<std::mutex> lock(depot.m_mutex);
+            for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+            {
+                if (m_lists[i].m_count > 0)
+                {
+                    depot.m_batches[i].push_back(m_lists[i]);
+                    m_lists[i] = ST_FreeList();
+                }
+            }
+        }
+    };
+
+    thread_local ST_ThreadBlockCache t_blockCache; ///< 当前线程的块缓存
+}
+
+void* TaskBlockPool::Allocate(size_t size)
+{
+    if (size > MAX_POOLED_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    size_t index = SizeClassIndex(size);
+    ST_FreeList& list = t_blockCache.m_lists[index];
+    if (list.m_head == nullptr)
+    {
+        ST_BlockDepot& depot = GetDepot();
+        std::lock_guard<std::mutex> lock(depot.m_mutex);
+        if (!depot.m_batches[index].empty())
+        {
+            list = depot.m_batches[index].back();
+            depot.m_batches[index].pop_back();
+        }
+    }
+
+    if (list.m_head == nullptr)
+    {
+        return ::operator new(SizeClassBytes(index));
+    }
+
+    ST_FreeBlock* block = list.m_head;
+    list.m_head = block->m_next;
+    --list.m_count;
+    return block;
+}
+
+void TaskBlockPool::Deallocate(void* block, size_t size) noexcept
+{
+    if (block == nullptr)
+    {
+        return;
+    }
+
+    if (size > MAX_POOLED_SIZE)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    size_t index = SizeClassIndex(size);
+    ST_FreeList& list = t_blockCache.m_lists[index];
+    ST_FreeBlock* freeBlock = static_cast<ST_FreeBlock*>(block);
+    freeBlock->m_next = list.m_head;
+    list.m_head = freeBlock;
+    ++list.m_count;
+
+    // 本地缓存过多时把一批空闲块交给全局仓库，供其他线程分配
+    if (list.m_count >= BATCH_SIZE * 2)
+    {
+        ST_FreeList batch;
+        for (size_t i = 0; i < BATCH_SIZE; ++i)
+        {
+            ST_FreeBlock* moved = list.m_head;
+            list.m_head = moved->m_next;
+            moved->m_next = batch.m_head;
+            batch.m_head = moved;
+        }
+        batch.m_count = BATCH_SIZE;
+        list.m_count -= BATCH_SIZE;
+
+        ST_BlockDepot& depot = GetDepot();
+        try
+        {
+            std::lock_guard<std::mutex> lock(depot.m_mutex);
+            depot.m_batches[index].push_back(batch);
+        }
+        catch (...)
+        {
+            // 仓库无法扩容时直接释放这一批
+            while (batch.m_head != nullptr)
+            {
+                ST_FreeBlock* next = batch.m_head->m_next;
+                ::operator delete(batch.m_head);
+                batch.m_head = next;
+            }
+        }
+    }
+}
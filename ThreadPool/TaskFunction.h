@@ -0,0 +1,292 @@
+﻿/// <summary>
+/// 线程池任务函数头文件 - 仅可移动、带内联存储的类型擦除可调用对象
+/// </summary>
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "../SDKCommonDefine/SDK_Export.h"
+
+/// <summary>
+/// 任务内存块池，为超出内联存储的任务对象提供按大小分级的复用内存块
+/// 每个线程持有本地空闲链表，超出上限时成批归还到全局仓库，跨线程分配/释放也能复用
+/// </summary>
+class SDK_API TaskBlockPool
+{
+public:
+    static constexpr size_t MAX_POOLED_SIZE = 1024; ///< 可池化的最大块大小，更大的对象直接使用operator new
+
+    /// <summary>
+    /// 分配内存块
+    /// </summary>
+    /// <param name="size">请求字节数</param>
+    /// <returns>内存块指针，按std::max_align_t对齐</returns>
+    static void* Allocate(size_t size);
+
+    /// <summary>
+    /// 释放内存块
+    /// </summary>
+    /// <param name="block">内存块指针</param>
+    /// <param name="size">分配时请求的字节数</param>
+    static void Deallocate(void* block, size_t size) noexcept;
+};
+
+/// <summary>
+/// 任务函数，替代std::function&lt;void()&gt;
+/// 仅可移动，不要求可调用对象可拷贝（可直接保存std::packaged_task），
+/// 不超过INLINE_SIZE字节的可调用对象保存在对象内部，不产生堆分配
+/// </summary>
+class TaskFunction
+{
+public:
+    static constexpr size_t INLINE_SIZE = 64; ///< 内联存储大小
+
+    /// <summary>
+    /// 默认构造函数，构造空任务
+    /// </summary>
+    TaskFunction() noexcept = default;
+
+    /// <summary>
+    /// 构造空任务
+    /// </summary>
+    TaskFunction(std::nullptr_t) noexcept
+    {
+    }
+
+    /// <summary>
+    /// 从任意无参可调用对象构造
+    /// </summary>
+    /// <param name="func">可调用对象</param>
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, TaskFunction> && !std::is_same_v<std::decay_t<F>, std::nullptr_t>>>
+    TaskFunction(F&& func)
+    {
+        Emplace(std::forward<F>(func));
+    }
+
+    /// <summary>
+    /// 移动构造函数
+    /// </summary>
+    TaskFunction(TaskFunction&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    /// <summary>
+    /// 移动赋值运算符
+    /// </summary>
+    TaskFunction& operator=(TaskFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    /// <summary>
+    /// 置空
+    /// </summary>
+    TaskFunction& operator=(std::nullptr_t) noexcept
+    {
+        Reset();
+        return *this;
+    }
+
+    /// <summary>
+    /// 从任意无参可调用对象赋值
+    /// </summary>
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, TaskFunction> && !std::is_same_v<std::decay_t<F>, std::nullptr_t>>>
+    TaskFunction& operator=(F&& func)
+    {
+        Reset();
+        Emplace(std::forward<F>(func));
+        return *this;
+    }
+
+    // 禁用拷贝构造和赋值
+    TaskFunction(const TaskFunction&) = delete;
+    TaskFunction& operator=(const TaskFunction&) = delete;
+
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~TaskFunction()
+    {
+        Reset();
+    }
+
+    /// <summary>
+    /// 执行任务
+    /// </summary>
+    void operator()()
+    {
+        if (m_vtable == nullptr)
+        {
+            throw std::bad_function_call();
+        }
+        m_vtable->m_invoke(m_storage);
+    }
+
+    /// <summary>
+    /// 是否保存了可调用对象
+    /// </summary>
+    explicit operator bool() const noexcept
+    {
+        return m_vtable != nullptr;
+    }
+
+    /// <summary>
+    /// 可调用对象是否保存在内联存储中
+    /// </summary>
+    bool IsInline() const noexcept
+    {
+        return m_vtable != nullptr && m_vtable->m_inline;
+    }
+
+private:
+    /// <summary>
+    /// 类型擦除操作表
+    /// </summary>
+    struct ST_VTable
+    {
+        void (*m_invoke)(void* storage);                         ///< 调用
+        void (*m_move)(void* dst, void* src) noexcept;           ///< 移动到新存储并销毁源对象
+        void (*m_destroy)(void* storage) noexcept;               ///< 销毁
+        bool m_inline;                                           ///< 是否内联存储
+    };
+
+    /// <summary>
+    /// 判断可调用对象能否内联存储
+    /// </summary>
+    template <typename T>
+    static constexpr bool FitsInline = sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>;
+
+    /// <summary>
+    /// 内联存储的操作实现
+    /// </summary>
+    template <typename T>
+    struct InlineOps
+    {
+        static void Invoke(void* storage) { (*static_cast<T*>(storage))(); }
+
+        static void Move(void* dst, void* src) noexcept
+        {
+            T* source = static_cast<T*>(src);
+            ::new (dst) T(std::move(*source));
+            source->~T();
+        }
+
+        static void Destroy(void* storage) noexcept { static_cast<T*>(storage)->~T(); }
+
+        static constexpr ST_VTable VTABLE{&Invoke, &Move, &Destroy, true};
+    };
+
+    /// <summary>
+    /// 池化堆存储的操作实现，内联存储中只保存对象指针
+    /// </summary>
+    template <typename T>
+    struct HeapOps
+    {
+        static T* Get(void* storage) { return *static_cast<T**>(storage); }
+
+        static void Invoke(void* storage) { (*Get(storage))(); }
+
+        static void Move(void* dst, void* src) noexcept { *static_cast<T**>(dst) = Get(src); }
+
+        static void Destroy(void* storage) noexcept
+        {
+            T* object = Get(storage);
+            object->~T();
+            if constexpr (alignof(T) <= alignof(std::max_align_t))
+            {
+                TaskBlockPool::Deallocate(object, sizeof(T));
+            }
+            else
+            {
+                ::operator delete(object, std::align_val_t(alignof(T)));
+            }
+        }
+
+        static constexpr ST_VTable VTABLE{&Invoke, &Move, &Destroy, false};
+    };
+
+    /// <summary>
+    /// 构造可调用对象
+    /// </summary>
+    template <typename F>
+    void Emplace(F&& func)
+    {
+        using T = std::decay_t<F>;
+        static_assert(std::is_invocable_v<T&>, "TaskFunction requires a callable taking no arguments");
+
+        if constexpr (FitsInline<T>)
+        {
+            ::new (static_cast<void*>(m_storage)) T(std::forward<F>(func));
+            m_vtable = &InlineOps<T>::VTABLE;
+        }
+        else
+        {
+            void* block = nullptr;
+            if constexpr (alignof(T) <= alignof(std::max_align_t))
+            {
+                block = TaskBlockPool::Allocate(sizeof(T));
+                try
+                {
+                    ::new (block) T(std::forward<F>(func));
+                }
+                catch (...)
+                {
+                    TaskBlockPool::Deallocate(block, sizeof(T));
+                    throw;
+                }
+            }
+            else
+            {
+                block = ::operator new(sizeof(T), std::align_val_t(alignof(T)));
+                try
+                {
+                    ::new (block) T(std::forward<F>(func));
+                }
+                catch (...)
+                {
+                    ::operator delete(block, std::align_val_t(alignof(T)));
+                    throw;
+                }
+            }
+            *reinterpret_cast<T**>(m_storage) = static_cast<T*>(block);
+            m_vtable = &HeapOps<T>::VTABLE;
+        }
+    }
+
+    /// <summary>
+    /// 从另一个对象移动
+    /// </summary>
+    void MoveFrom(TaskFunction& other) noexcept
+    {
+        if (other.m_vtable != nullptr)
+        {
+            other.m_vtable->m_move(m_storage, other.m_storage);
+            m_vtable = other.m_vtable;
+            other.m_vtable = nullptr;
+        }
+    }
+
+    /// <summary>
+    /// 销毁当前保存的对象
+    /// </summary>
+    void Reset() noexcept
+    {
+        if (m_vtable != nullptr)
+        {
+            m_vtable->m_destroy(m_storage);
+            m_vtable = nullptr;
+        }
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char m_storage[INLINE_SIZE]; ///< 内联存储
+    const ST_VTable* m_vtable{nullptr};                             ///< 操作表，为空表示空任务
+};
@@ -0,0 +1,746 @@
+﻿/// <summary>
+/// 线程池轻量级future头文件 - 支持非阻塞Then续接以及WhenAll/WhenAny组合
+/// </summary>
+#pragma once
+#include <atomic>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "ThreadPool.h"
+
+template <typename T>
+class TaskFuture;
+
+template <typename T>
+class TaskPromise;
+
+template <typename T>
+struct ST_FutureAwaiter;
+
+/// <summary>
+/// future共享状态，由TaskPromise与TaskFuture通过引用计数共享
+/// </summary>
+template <typename T>
+class FutureSharedState
+{
+public:
+    using ValueType = std::conditional_t<std::is_void_v<T>, std::monostate, T>; ///< 实际保存的值类型
+
+    static constexpr uint32_t FLAG_READY = 1;        ///< 已设置结果
+    static constexpr uint32_t FLAG_CONTINUATION = 2; ///< 已挂接续接任务
+
+    /// <summary>
+    /// 从复用池获取共享状态，引用计数初始为1
+    /// </summary>
+    static FutureSharedState* Create()
+    {
+        FreeList& freeList = GetFreeList();
+        FutureSharedState* state = nullptr;
+        if (!freeList.m_states.empty())
+        {
+            state = freeList.m_states.back();
+            freeList.m_states.pop_back();
+        }
+        else
+        {
+            state = new FutureSharedState();
+        }
+        state->m_refCount.store(1, std::memory_order_relaxed);
+        return state;
+    }
+
+    /// <summary>
+    /// 增加引用
+    /// </summary>
+    void AddRef()
+    {
+        m_refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// <summary>
+    /// 释放引用，最后一个引用释放时清理并归还复用池
+    /// </summary>
+    void Release()
+    {
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        m_value.reset();
+        m_exception = nullptr;
+        m_continuation = nullptr;
+        m_continuationPool = nullptr;
+        m_flags.store(0, std::memory_order_relaxed);
+
+        FreeList& freeList = GetFreeList();
+        if (freeList.m_states.size() < MAX_CACHED_STATES)
+        {
+            freeList.m_states.push_back(this);
+        }
+        else
+        {
+            delete this;
+        }
+    }
+
+    /// <summary>
+    /// 设置结果值
+    /// </summary>
+    template <typename... Args>
+    void SetValue(Args&&... args)
+    {
+        m_value.emplace(std::forward<Args>(args)...);
+        MarkReady();
+    }
+
+    /// <summary>
+    /// 设置异常
+    /// </summary>
+    void SetException(std::exception_ptr exception)
+    {
+        m_exception = std::move(exception);
+        MarkReady();
+    }
+
+    /// <summary>
+    /// 是否已设置结果
+    /// </summary>
+    bool IsReady() const
+    {
+        return (m_flags.load(std::memory_order_acquire) & FLAG_READY) != 0;
+    }
+
+    /// <summary>
+    /// 阻塞等待结果
+    /// </summary>
+    void Wait() const
+    {
+        uint32_t flags = m_flags.load(std::memory_order_acquire);
+        while ((flags & FLAG_READY) == 0)
+        {
+            m_flags.wait(flags, std::memory_order_acquire);
+            flags = m_flags.load(std::memory_order_acquire);
+        }
+    }
+
+    /// <summary>
+    /// 取出结果，有异常时重新抛出
+    /// </summary>
+    ValueType TakeValue()
+    {
+        if (m_exception)
+        {
+            std::rethrow_exception(m_exception);
+        }
+        return std::move(*m_value);
+    }
+
+    /// <summary>
+    /// 获取异常
+    /// </summary>
+    std::exception_ptr GetException() const
+    {
+        return m_exception;
+    }
+
+    /// <summary>
+    /// 挂接续接任务，结果就绪时投递到指定线程池；线程池为空时在设置结果的线程上直接执行
+    /// 每个共享状态只能挂接一个续接任务
+    /// </summary>
+    void SetContinuation(TaskFunction continuation, ThreadPool* pool, EM_TaskPriority priority)
+    {
+        m_continuation = std::move(continuation);
+        m_continuationPool = pool;
+        m_continuationPriority = priority;
+
+        uint32_t previous = m_flags.fetch_or(FLAG_CONTINUATION, std::memory_order_acq_rel);
+        if ((previous & FLAG_READY) != 0)
+        {
+            RunContinuation();
+        }
+    }
+
+private:
+    static constexpr size_t MAX_CACHED_STATES = 256; ///< 每个线程缓存的共享状态上限
+
+    /// <summary>
+    /// 线程本地空闲列表
+    /// </summary>
+    struct FreeList
+    {
+        std::vector<FutureSharedState*> m_states; ///< 空闲状态
+
+        ~FreeList()
+        {
+            for (FutureSharedState* state : m_states)
+            {
+                delete state;
+            }
+        }
+    };
+
+    /// <summary>
+    /// 获取当前线程的空闲列表
+    /// </summary>
+    static FreeList& GetFreeList()
+    {
+        static thread_local FreeList freeList;
+        return freeList;
+    }
+
+    FutureSharedState() = default;
+
+    /// <summary>
+    /// 标记结果就绪，唤醒等待者并调度续接任务
+    /// </summary>
+    void MarkReady()
+    {
+        uint32_t previous = m_flags.fetch_or(FLAG_READY, std::memory_order_acq_rel);
+        m_flags.notify_all();
+        if ((previous & FLAG_CONTINUATION) != 0)
+        {
+            RunContinuation();
+        }
+    }
+
+    /// <summary>
+    /// 执行或投递续接任务
+    /// </summary>
+    void RunContinuation()
+    {
+        TaskFunction continuation = std::move(m_continuation);
+        if (m_continuationPool != nullptr)
+        {
+            // 线程池已停止或队列已满时在当前线程执行，续接不会被丢弃
+            m_continuationPool->PostOrRun(std::move(continuation), m_continuationPriority);
+            return;
+        }
+        continuation();
+    }
+
+private:
+    std::atomic<uint32_t> m_refCount{0};        ///< 引用计数
+    std::atomic<uint32_t> m_flags{0};           ///< 状态标志
+    std::optional<ValueType> m_value;           ///< 结果值
+    std::exception_ptr m_exception;             ///< 异常
+    TaskFunction m_continuation;                ///< 续接任务
+    ThreadPool* m_continuationPool{nullptr};    ///< 续接任务投递的线程池
+    EM_TaskPriority m_continuationPriority{EM_TaskPriority::Normal}; ///< 续接任务优先级
+};
+
+/// <summary>
+/// 续接函数返回值类型，上游结果为void时续接函数无参数
+/// </summary>
+template <typename F, typename T>
+struct ST_ContinuationResult
+{
+    using Type = std::invoke_result_t<F&, T>;
+};
+
+template <typename F>
+struct ST_ContinuationResult<F, void>
+{
+    using Type = std::invoke_result_t<F&>;
+};
+
+/// <summary>
+/// 共享状态的引用计数句柄
+/// </summary>
+template <typename T>
+class FutureStateRef
+{
+public:
+    FutureStateRef() = default;
+
+    explicit FutureStateRef(FutureSharedState<T>* state)
+        : m_state(state)
+    {
+    }
+
+    FutureStateRef(const FutureStateRef& other)
+        : m_state(other.m_state)
+    {
+        if (m_state != nullptr)
+        {
+            m_state->AddRef();
+        }
+    }
+
+    FutureStateRef(FutureStateRef&& other) noexcept
+        : m_state(std::exchange(other.m_state, nullptr))
+    {
+    }
+
+    FutureStateRef& operator=(FutureStateRef other) noexcept
+    {
+        std::swap(m_state, other.m_state);
+        return *this;
+    }
+
+    ~FutureStateRef()
+    {
+        if (m_state != nullptr)
+        {
+            m_state->Release();
+        }
+    }
+
+    FutureSharedState<T>* operator->() const { return m_state; }
+
+    explicit operator bool() const { return m_state != nullptr; }
+
+private:
+    FutureSharedState<T>* m_state{nullptr}; ///< 共享状态
+};
+
+/// <summary>
+/// 轻量级promise，结果通过TaskFuture获取
+/// </summary>
+template <typename T>
+class TaskPromise
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="pool">续接任务默认投递的线程池，为空时续接在设置结果的线程上执行</param>
+    explicit TaskPromise(ThreadPool* pool = nullptr)
+        : m_state(FutureSharedState<T>::Create())
+        , m_pool(pool)
+    {
+    }
+
+    TaskPromise(TaskPromise&& other) noexcept = default;
+    TaskPromise& operator=(TaskPromise&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Abandon();
+            m_state = std::move(other.m_state);
+            m_pool = other.m_pool;
+            m_satisfied = other.m_satisfied;
+            m_futureRetrieved = other.m_futureRetrieved;
+        }
+        return *this;
+    }
+
+    // 禁用拷贝构造和赋值
+    TaskPromise(const TaskPromise&) = delete;
+    TaskPromise& operator=(const TaskPromise&) = delete;
+
+    /// <summary>
+    /// 析构函数，未设置结果时以broken_promise异常完成future
+    /// </summary>
+    ~TaskPromise()
+    {
+        Abandon();
+    }
+
+    /// <summary>
+    /// 获取关联的future，只能调用一次
+    /// </summary>
+    TaskFuture<T> GetFuture()
+    {
+        if (m_futureRetrieved)
+        {
+            throw std::future_error(std::future_errc::future_already_retrieved);
+        }
+        m_futureRetrieved = true;
+        return TaskFuture<T>(m_state, m_pool);
+    }
+
+    /// <summary>
+    /// 设置结果值
+    /// </summary>
+    template <typename... Args>
+    void SetValue(Args&&... args)
+    {
+        CheckNotSatisfied();
+        m_satisfied = true;
+        m_state->SetValue(std::forward<Args>(args)...);
+    }
+
+    /// <summary>
+    /// 设置异常
+    /// </summary>
+    void SetException(std::exception_ptr exception)
+    {
+        CheckNotSatisfied();
+        m_satisfied = true;
+        m_state->SetException(std::move(exception));
+    }
+
+private:
+    /// <summary>
+    /// 检查结果尚未设置
+    /// </summary>
+    void CheckNotSatisfied() const
+    {
+        if (!m_state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        if (m_satisfied)
+        {
+            throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+    }
+
+    /// <summary>
+    /// 放弃promise
+    /// </summary>
+    void Abandon()
+    {
+        if (m_state && !m_satisfied)
+        {
+            m_satisfied = true;
+            m_state->SetException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+
+private:
+    FutureStateRef<T> m_state;     ///< 共享状态
+    ThreadPool* m_pool{nullptr};   ///< 续接任务默认投递的线程池
+    bool m_satisfied{false};       ///< 是否已设置结果
+    bool m_futureRetrieved{false}; ///< 是否已获取future
+};
+
+/// <summary>
+/// 轻量级future，可阻塞获取结果，也可通过Then挂接在线程池上执行的续接任务
+/// </summary>
+template <typename T>
+class TaskFuture
+{
+public:
+    TaskFuture() = default;
+    TaskFuture(TaskFuture&&) noexcept = default;
+    TaskFuture& operator=(TaskFuture&&) noexcept = default;
+
+    // 禁用拷贝构造和赋值
+    TaskFuture(const TaskFuture&) = delete;
+    TaskFuture& operator=(const TaskFuture&) = delete;
+
+    /// <summary>
+    /// 是否关联了共享状态
+    /// </summary>
+    bool IsValid() const { return static_cast<bool>(m_state); }
+
+    /// <summary>
+    /// 结果是否已就绪
+    /// </summary>
+    bool IsReady() const { return m_state && m_state->IsReady(); }
+
+    /// <summary>
+    /// 阻塞等待结果就绪
+    /// </summary>
+    void Wait() const
+    {
+        CheckValid();
+        m_state->Wait();
+    }
+
+    /// <summary>
+    /// 阻塞获取结果，任务抛出的异常在此重新抛出；调用后future失效
+    /// </summary>
+    T Get()
+    {
+        CheckValid();
+        m_state->Wait();
+        FutureStateRef<T> state = std::move(m_state);
+        if constexpr (std::is_void_v<T>)
+        {
+            state->TakeValue();
+        }
+        else
+        {
+            return state->TakeValue();
+        }
+    }
+
+    /// <summary>
+    /// 挂接续接任务，结果就绪后投递到线程池执行，不阻塞任何线程；调用后当前future失效
+    /// 上游异常直接传递给返回的future，不会调用func
+    /// </summary>
+    /// <param name="func">续接函数，参数为上游结果（void时无参数）</param>
+    /// <param name="priority">续接任务优先级</param>
+    /// <returns>续接结果的future</returns>
+    template <typename F>
+    auto Then(F&& func, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        using ResultType = typename ST_ContinuationResult<std::decay_t<F>, T>::Type;
+
+        CheckValid();
+        TaskPromise<ResultType> promise(m_pool);
+        TaskFuture<ResultType> result = promise.GetFuture();
+
+        FutureStateRef<T> source = m_state;
+        FutureSharedState<T>* rawSource = source.operator->();
+        rawSource->SetContinuation(
+            [source = std::move(source), promise = std::move(promise), func = std::forward<F>(func)]() mutable
+            {
+                try
+                {
+                    if (std::exception_ptr exception = source->GetException())
+                    {
+                        promise.SetException(exception);
+                    }
+                    else if constexpr (std::is_void_v<T>)
+                    {
+                        if constexpr (std::is_void_v<ResultType>)
+                        {
+                            func();
+                            promise.SetValue();
+                        }
+                        else
+                        {
+                            promise.SetValue(func());
+                        }
+                    }
+                    else
+                    {
+                        if constexpr (std::is_void_v<ResultType>)
+                        {
+                            func(source->TakeValue());
+                            promise.SetValue();
+                        }
+                        else
+                        {
+                            promise.SetValue(func(source->TakeValue()));
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    promise.SetException(std::current_exception());
+                }
+            },
+            m_pool, priority);
+
+        m_state = FutureStateRef<T>();
+        return result;
+    }
+
+private:
+    template <typename U>
+    friend class TaskPromise;
+
+    template <typename U>
+    friend class TaskFuture;
+
+    template <typename U>
+    friend TaskFuture<std::conditional_t<std::is_void_v<U>, void, std::vector<U>>> WhenAll(std::vector<TaskFuture<U>> futures);
+
+    template <typename U>
+    friend TaskFuture<size_t> WhenAny(const std::vector<TaskFuture<U>>& futures);
+
+    template <typename U>
+    friend struct ST_FutureAwaiter;
+
+    TaskFuture(FutureStateRef<T> state, ThreadPool* pool)
+        : m_state(std::move(state))
+        , m_pool(pool)
+    {
+    }
+
+    /// <summary>
+    /// 检查future有效
+    /// </summary>
+    void CheckValid() const
+    {
+        if (!m_state)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+    }
+
+private:
+    FutureStateRef<T> m_state;   ///< 共享状态
+    ThreadPool* m_pool{nullptr}; ///< 续接任务投递的线程池
+};
+
+/// <summary>
+/// 等待所有future完成，结果按输入顺序汇总；任一future失败时返回的future以第一个异常完成
+/// </summary>
+/// <param name="futures">输入future，调用后全部失效</param>
+/// <returns>汇总结果的future（输入为void时结果也为void）</returns>
+template <typename T>
+TaskFuture<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> WhenAll(std::vector<TaskFuture<T>> futures)
+{
+    using ResultType = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+    using SlotType = std::conditional_t<std::is_void_v<T>, std::monostate, std::optional<T>>;
+
+    /// 汇总上下文，最后一个完成的输入负责设置结果并释放
+    struct ST_WhenAllContext
+    {
+        std::atomic<size_t> m_remaining{0};
+        std::atomic<bool> m_failed{false};
+        std::vector<SlotType> m_results;
+        std::exception_ptr m_exception;
+        TaskPromise<ResultType> m_promise;
+
+        explicit ST_WhenAllContext(size_t count, ThreadPool* pool)
+            : m_remaining(count + 1)
+            , m_results(count)
+            , m_promise(pool)
+        {
+        }
+
+        void Complete()
+        {
+            if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+
+            if (m_exception)
+            {
+                m_promise.SetException(m_exception);
+            }
+            else if constexpr (std::is_void_v<T>)
+            {
+                m_promise.SetValue();
+            }
+            else
+            {
+                std::vector<T> values;
+                values.reserve(m_results.size());
+                for (auto& slot : m_results)
+                {
+                    values.push_back(std::move(*slot));
+                }
+                m_promise.SetValue(std::move(values));
+            }
+            delete this;
+        }
+    };
+
+    ThreadPool* pool = futures.empty() ? nullptr : futures.front().m_pool;
+    auto* context = new ST_WhenAllContext(futures.size(), pool);
+    TaskFuture<ResultType> result = context->m_promise.GetFuture();
+
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        futures[i].CheckValid();
+        FutureStateRef<T> source = std::move(futures[i].m_state);
+        FutureSharedState<T>* rawSource = source.operator->();
+        // 在设置结果的线程上直接汇总，不额外占用线程池调度
+        rawSource->SetContinuation(
+            [context, i, source = std::move(source)]() mutable
+            {
+                if (std::exception_ptr exception = source->GetException())
+                {
+                    bool expected = false;
+                    if (context->m_failed.compare_exchange_strong(expected, true))
+                    {
+                        context->m_exception = exception;
+                    }
+                }
+                else if constexpr (!std::is_void_v<T>)
+                {
+                    context->m_results[i].emplace(source->TakeValue());
+                }
+                context->Complete();
+            },
+            nullptr, EM_TaskPriority::Normal);
+    }
+
+    // 额外的一次计数保证注册过程中不会提前完成
+    context->Complete();
+    return result;
+}
+
+/// <summary>
+/// 等待任一future完成，返回最先完成的下标；结果仍可通过对应的future获取
+/// 每个future只能挂接一个续接，参与WhenAny后不能再调用Then
+/// </summary>
+/// <param name="futures">输入future</param>
+/// <returns>最先完成的future下标</returns>
+template <typename T>
+TaskFuture<size_t> WhenAny(const std::vector<TaskFuture<T>>& futures)
+{
+    /// 竞争上下文，所有输入都完成后释放
+    struct ST_WhenAnyContext
+    {
+        std::atomic<size_t> m_remaining{0};
+        std::atomic<bool> m_done{false};
+        TaskPromise<size_t> m_promise;
+
+        explicit ST_WhenAnyContext(size_t count, ThreadPool* pool)
+            : m_remaining(count)
+            , m_promise(pool)
+        {
+        }
+
+        void Complete(size_t index)
+        {
+            bool expected = false;
+            if (m_done.compare_exchange_strong(expected, true))
+            {
+                m_promise.SetValue(index);
+            }
+            if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete this;
+            }
+        }
+    };
+
+    if (futures.empty())
+    {
+        throw std::invalid_argument("WhenAny requires at least one future");
+    }
+
+    auto* context = new ST_WhenAnyContext(futures.size(), futures.front().m_pool);
+    TaskFuture<size_t> result = context->m_promise.GetFuture();
+
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        futures[i].CheckValid();
+        futures[i].m_state->SetContinuation(
+            [context, i]() mutable
+            {
+                context->Complete(i);
+            },
+            nullptr, EM_TaskPriority::Normal);
+    }
+    return result;
+}
+
+/// <summary>
+/// 提交任务到线程池，返回支持续接的TaskFuture
+/// </summary>
+template <typename F>
+auto ThreadPool::SubmitAsync(F&& f, EM_TaskPriority priority) -> TaskFuture<std::invoke_result_t<std::decay_t<F>&>>
+{
+    using ResultType = std::invoke_result_t<std::decay_t<F>&>;
+
+    TaskPromise<ResultType> promise(this);
+    TaskFuture<ResultType> future = promise.GetFuture();
+
+    Post([promise = std::move(promise), func = std::forward<F>(f)]() mutable
+    {
+        try
+        {
+            if constexpr (std::is_void_v<ResultType>)
+            {
+                func();
+                promise.SetValue();
+            }
+            else
+            {
+                promise.SetValue(func());
+            }
+        }
+        catch (...)
+        {
+            promise.SetException(std::current_exception());
+        }
+    }, priority);
+
+    return future;
+}
@@ -0,0 +1,234 @@
+﻿/// <summary>
+/// 任务依赖图实现文件
+/// </summary>
+#include "TaskGraph.h"
+#include <stdexcept>
+
+TaskGraph::TaskGraph(ThreadPool& pool)
+    : m_pool(pool)
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+    Wait();
+}
+
+TaskGraph::NodeId TaskGraph::AddNodeImpl(std::unique_ptr<ST_TaskGraphNode> node)
+{
+    if (IsRunning())
+    {
+        throw std::logic_error("TaskGraph cannot be modified while running");
+    }
+
+    m_nodes.push_back(std::move(node));
+    return m_nodes.size() - 1;
+}
+
+void TaskGraph::AddEdge(NodeId from, NodeId to)
+{
+    if (from >= m_nodes.size() || to >= m_nodes.size())
+    {
+        throw std::out_of_range("TaskGraph node id out of range");
+    }
+    if (from == to)
+    {
+        throw std::logic_error("TaskGraph node cannot depend on itself");
+    }
+    if (IsRunning())
+    {
+        throw std::logic_error("TaskGraph cannot be modified while running");
+    }
+
+    m_nodes[from]->m_successors.push_back(to);
+    ++m_nodes[to]->m_predecessorCount;
+    m_validated = false;
+}
+
+TaskFuture<void> TaskGraph::Run()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_runMutex);
+        if (m_running)
+        {
+            throw std::logic_error("TaskGraph is already running");
+        }
+        if (!m_validated)
+        {
+            Validate();
+        }
+        m_running = true;
+    }
+
+    m_promise = TaskPromise<void>(&m_pool);
+    TaskFuture<void> future = m_promise.GetFuture();
+    m_exception = nullptr;
+    m_failed.store(false, std::memory_order_relaxed);
+
+    if (m_nodes.empty())
+    {
+        CompleteRun();
+        return future;
+    }
+
+    // 先重置所有计数再投递，避免早完成的节点读到上一次运行的计数
+    m_remaining.store(m_nodes.size(), std::memory_order_relaxed);
+    for (auto& node : m_nodes)
+    {
+        node->m_pendingDependencies.store(node->m_predecessorCount, std::memory_order_relaxed);
+    }
+
+    // 先收集根节点：投递后本次运行随时可能结束，之后不能再遍历节点
+    std::vector<NodeId> roots;
+    for (NodeId id = 0; id < m_nodes.size(); ++id)
+    {
+        if (m_nodes[id]->m_predecessorCount == 0)
+        {
+            roots.push_back(id);
+        }
+    }
+    for (NodeId id : roots)
+    {
+        Schedule(id);
+    }
+    return future;
+}
+
+void TaskGraph::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_runMutex);
+    m_runCondition.wait(lock, [this] { return !m_running; });
+}
+
+bool TaskGraph::IsRunning() const
+{
+    std::lock_guard<std::mutex> lock(m_runMutex);
+    return m_running;
+}
+
+void TaskGraph::Validate()
+{
+    // Kahn算法：能按拓扑序取出全部节点则无环
+    std::vector<size_t> inDegree(m_nodes.size());
+    std::vector<NodeId> ready;
+    for (NodeId id = 0; id < m_nodes.size(); ++id)
+    {
+        inDegree[id] = m_nodes[id]->m_predecessorCount;
+        if (inDegree[id] == 0)
+        {
+            ready.push_back(id);
+        }
+    }
+
+    size_t visited = 0;
+    while (!ready.empty())
+    {
+        NodeId id = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (NodeId successor : m_nodes[id]->m_successors)
+        {
+            if (--inDegree[successor] == 0)
+            {
+                ready.push_back(successor);
+            }
+        }
+    }
+
+    if (visited != m_nodes.size())
+    {
+        throw std::logic_error("TaskGraph contains a cycle");
+    }
+    m_validated = true;
+}
+
+void TaskGraph::Schedule(NodeId id)
+{
+    m_pool.PostOrRun(ST_NodeTask(this, id), m_nodes[id]->m_priority);
+}
+
+void TaskGraph::AbandonNode(NodeId id)
+{
+    Fail(std::make_exception_ptr(TaskCancelledException()));
+    ExecuteNode(id);
+}
+
+void TaskGraph::Fail(std::exception_ptr exception)
+{
+    bool expected = false;
+    if (m_failed.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+    {
+        m_exception = exception;
+    }
+}
+
+void TaskGraph::ExecuteNode(NodeId id)
+{
+    while (true)
+    {
+        ST_TaskGraphNode& node = *m_nodes[id];
+        if (!m_failed.load(std::memory_order_acquire))
+        {
+            try
+            {
+                node.m_func();
+            }
+            catch (...)
+            {
+                Fail(std::current_exception());
+            }
+        }
+
+        // 释放后继，第一个就绪的后继留在当前线程执行，省去一次入队与唤醒
+        bool hasNext = false;
+        NodeId next = 0;
+        for (NodeId successor : node.m_successors)
+        {
+            if (m_nodes[successor]->m_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                if (!hasNext)
+                {
+                    hasNext = true;
+                    next = successor;
+                }
+                else
+                {
+                    Schedule(successor);
+                }
+            }
+        }
+
+        // 最后一个结束的节点负责完成本次运行；计数递减之后不能再访问节点
+        if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            CompleteRun();
+            return;
+        }
+        if (!hasNext)
+        {
+            return;
+        }
+        id = next;
+    }
+}
+
+void TaskGraph::CompleteRun()
+{
+    // 先取出通知对象，解除运行状态后任务图可能立即被重新运行或销毁
+    TaskPromise<void> promise = std::move(m_promise);
+    std::exception_ptr exception = m_exception;
+    {
+        std::lock_guard<std::mutex> lock(m_runMutex);
+        m_running = false;
+        m_runCondition.notify_all();
+    }
+
+    if (exception)
+    {
+        promise.SetException(exception);
+    }
+    else
+    {
+        promise.SetValue();
+    }
+}
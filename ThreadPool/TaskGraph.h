@@ -0,0 +1,181 @@
+﻿/// <summary>
+/// 任务依赖图头文件 - 前驱全部完成后立即把节点投递到线程池，执行过程中没有线程阻塞等待
+/// </summary>
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "TaskFuture.h"
+
+/// <summary>
+/// 任务依赖图
+/// 节点与边在运行前构建，同一张图可以反复运行；运行期间不允许修改图结构。
+/// 任一节点抛出异常后，本次运行中尚未开始的节点不再执行其函数，异常通过Run返回的future和Wait传出；
+/// 节点任务被线程池丢弃（线程池停止）时本次运行以TaskCancelledException失败，运行仍会结束
+/// </summary>
+class SDK_API TaskGraph
+{
+public:
+    using NodeId = size_t; ///< 节点编号，按AddNode调用顺序从0开始
+
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="pool">执行节点的线程池，需比任务图存活更久</param>
+    explicit TaskGraph(ThreadPool& pool);
+
+    /// <summary>
+    /// 析构函数，等待正在进行的运行结束
+    /// </summary>
+    ~TaskGraph();
+
+    // 禁用拷贝构造和赋值
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    /// <summary>
+    /// 添加节点
+    /// </summary>
+    /// <param name="func">节点函数，每次运行调用一次</param>
+    /// <param name="priority">节点投递到线程池时的优先级</param>
+    /// <returns>节点编号</returns>
+    template <typename F>
+    NodeId AddNode(F&& func, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        auto node = std::make_unique<ST_TaskGraphNode>();
+        node->m_func = std::forward<F>(func);
+        node->m_priority = priority;
+        return AddNodeImpl(std::move(node));
+    }
+
+    /// <summary>
+    /// 添加依赖边，from完成后to才能开始
+    /// </summary>
+    /// <param name="from">前驱节点</param>
+    /// <param name="to">后继节点</param>
+    void AddEdge(NodeId from, NodeId to);
+
+    /// <summary>
+    /// 开始一次运行，立即返回；入度为0的节点投递到线程池，其余节点在前驱全部完成时由最后完成的前驱释放
+    /// </summary>
+    /// <returns>本次运行完成时就绪的future</returns>
+    TaskFuture<void> Run();
+
+    /// <summary>
+    /// 阻塞等待当前运行结束，未在运行时立即返回；不传出异常
+    /// </summary>
+    void Wait();
+
+    /// <summary>
+    /// 是否正在运行
+    /// </summary>
+    bool IsRunning() const;
+
+    /// <summary>
+    /// 获取节点数量
+    /// </summary>
+    size_t GetNodeCount() const { return m_nodes.size(); }
+
+private:
+    /// <summary>
+    /// 任务图节点
+    /// </summary>
+    struct ST_TaskGraphNode
+    {
+        TaskFunction m_func;                                   ///< 节点函数
+        EM_TaskPriority m_priority{EM_TaskPriority::Normal};   ///< 投递优先级
+        std::vector<NodeId> m_successors;                      ///< 后继节点
+        size_t m_predecessorCount{0};                          ///< 前驱数量（含重复边）
+        std::atomic<size_t> m_pendingDependencies{0};          ///< 本次运行中尚未完成的前驱数
+    };
+
+    /// <summary>
+    /// 投递到线程池的节点任务；未执行就被丢弃时在析构中放弃该节点，保证本次运行能够结束
+    /// </summary>
+    struct ST_NodeTask
+    {
+        TaskGraph* m_graph; ///< 所属任务图，为空表示已执行或已移走
+        NodeId m_id;        ///< 节点编号
+
+        ST_NodeTask(TaskGraph* graph, NodeId id)
+            : m_graph(graph)
+            , m_id(id)
+        {
+        }
+
+        ST_NodeTask(ST_NodeTask&& other) noexcept
+            : m_graph(std::exchange(other.m_graph, nullptr))
+            , m_id(other.m_id)
+        {
+        }
+
+        ST_NodeTask(const ST_NodeTask&) = delete;
+        ST_NodeTask& operator=(const ST_NodeTask&) = delete;
+        ST_NodeTask& operator=(ST_NodeTask&&) = delete;
+
+        ~ST_NodeTask()
+        {
+            if (TaskGraph* graph = std::exchange(m_graph, nullptr))
+            {
+                graph->AbandonNode(m_id);
+            }
+        }
+
+        void operator()()
+        {
+            std::exchange(m_graph, nullptr)->ExecuteNode(m_id);
+        }
+    };
+
+    /// <summary>
+    /// 保存节点并返回编号
+    /// </summary>
+    NodeId AddNodeImpl(std::unique_ptr<ST_TaskGraphNode> node);
+
+    /// <summary>
+    /// 检查图中是否存在环，存在时抛出std::logic_error
+    /// </summary>
+    void Validate();
+
+    /// <summary>
+    /// 把节点投递到线程池，投递失败（线程池已停止或队列已满）时在当前线程执行
+    /// </summary>
+    void Schedule(NodeId id);
+
+    /// <summary>
+    /// 执行节点并释放后继；第一个就绪的后继直接在当前线程继续执行，其余投递到线程池
+    /// </summary>
+    void ExecuteNode(NodeId id);
+
+    /// <summary>
+    /// 节点任务被线程池丢弃：本次运行标记为取消，之后的节点不再执行函数，只按正常流程释放后继并计数，
+    /// 该节点与其后继都计为结束
+    /// </summary>
+    void AbandonNode(NodeId id);
+
+    /// <summary>
+    /// 记录本次运行的第一个异常
+    /// </summary>
+    void Fail(std::exception_ptr exception);
+
+    /// <summary>
+    /// 所有节点结束后完成本次运行
+    /// </summary>
+    void CompleteRun();
+
+private:
+    ThreadPool& m_pool;                                     ///< 线程池
+    std::vector<std::unique_ptr<ST_TaskGraphNode>> m_nodes; ///< 所有节点
+    bool m_validated{true};                                 ///< 图结构自上次检查后未修改
+    std::atomic<size_t> m_remaining{0};                     ///< 本次运行中尚未结束的节点数
+    std::atomic<bool> m_failed{false};                      ///< 本次运行是否已有节点失败
+    std::exception_ptr m_exception;                         ///< 第一个失败节点的异常
+    TaskPromise<void> m_promise;                            ///< 本次运行的完成通知
+    bool m_running{false};                                  ///< 是否正在运行，受m_runMutex保护
+    mutable std::mutex m_runMutex;                          ///< 运行状态互斥锁
+    std::condition_variable m_runCondition;                 ///< 运行结束条件变量
+};
@@ -0,0 +1,61 @@
+﻿/// <summary>
+/// 任务组实现文件
+/// </summary>
+#include "TaskGroup.h"
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : m_pool(pool)
+    , m_waiter(pool)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    WaitForIdle();
+}
+
+void TaskGroup::Wait()
+{
+    WaitForIdle();
+
+    if (m_failed.load(std::memory_order_acquire))
+    {
+        std::exception_ptr exception = std::move(m_exception);
+        m_exception = nullptr;
+        m_failed.store(false, std::memory_order_release);
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskGroup::WaitForIdle()
+{
+    m_waiter.Wait([this]() { return m_outstanding.load(std::memory_order_acquire) == 0; });
+}
+
+void TaskGroup::Finish(std::exception_ptr exception) noexcept
+{
+    if (exception)
+    {
+        bool expected = false;
+        if (m_failed.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+        {
+            m_exception = std::move(exception);
+        }
+    }
+
+    // 非最后一个任务无锁递减
+    size_t current = m_outstanding.load(std::memory_order_relaxed);
+    while (current > 1)
+    {
+        if (m_outstanding.compare_exchange_weak(current, current - 1, std::memory_order_acq_rel))
+        {
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_waiter.GetMutex());
+    if (m_outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        m_waiter.NotifyAll();
+    }
+}
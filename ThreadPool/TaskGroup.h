@@ -0,0 +1,126 @@
+﻿/// <summary>
+/// 任务组头文件 - 原子计数未完成任务，最后一个任务结束时精确唤醒等待者
+/// </summary>
+#pragma once
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include "ThreadPool.h"
+
+/// <summary>
+/// 任务组，用于结构化等待一批相关任务
+/// 通过Run提交的任务全部结束后Wait返回，等待期间调用线程协助执行线程池队列中的任务；
+/// 任务抛出的第一个异常由Wait重新抛出。析构时等待剩余任务结束，不抛出异常
+/// </summary>
+class SDK_API TaskGroup
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="pool">执行任务的线程池，需比任务组存活更久</param>
+    explicit TaskGroup(ThreadPool& pool);
+
+    /// <summary>
+    /// 析构函数，等待剩余任务结束
+    /// </summary>
+    ~TaskGroup();
+
+    // 禁用拷贝构造和赋值
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// <summary>
+    /// 提交任务到线程池并计入本组；队列已满时按线程池的过载策略处理，被丢弃的任务按未执行处理，Wait会报告
+    /// </summary>
+    /// <param name="func">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    template <typename F>
+    void Run(F&& func, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        m_outstanding.fetch_add(1, std::memory_order_relaxed);
+        ST_GroupTask<std::decay_t<F>> task(this, std::forward<F>(func));
+        m_pool.Post(std::move(task), priority);
+    }
+
+    /// <summary>
+    /// 等待本组所有任务结束，并重新抛出第一个任务异常（抛出后清除，任务组可继续使用）
+    /// </summary>
+    void Wait();
+
+    /// <summary>
+    /// 获取尚未结束的任务数
+    /// </summary>
+    size_t GetOutstandingCount() const { return m_outstanding.load(std::memory_order_acquire); }
+
+private:
+    /// <summary>
+    /// 组内任务包装，执行后计数递减；未执行就被销毁（线程池停止或入队失败）时同样递减，保证Wait能够返回
+    /// </summary>
+    template <typename F>
+    struct ST_GroupTask
+    {
+        TaskGroup* m_group; ///< 所属任务组，为空表示已执行或已移走
+        F m_func;           ///< 任务函数
+
+        template <typename U>
+        ST_GroupTask(TaskGroup* group, U&& func)
+            : m_group(group)
+            , m_func(std::forward<U>(func))
+        {
+        }
+
+        ST_GroupTask(ST_GroupTask&& other) noexcept(std::is_nothrow_move_constructible_v<F>)
+            : m_group(std::exchange(other.m_group, nullptr))
+            , m_func(std::move(other.m_func))
+        {
+        }
+
+        ST_GroupTask(const ST_GroupTask&) = delete;
+        ST_GroupTask& operator=(const ST_GroupTask&) = delete;
+        ST_GroupTask& operator=(ST_GroupTask&&) = delete;
+
+        ~ST_GroupTask()
+        {
+            if (m_group != nullptr)
+            {
+                m_group->Finish(std::make_exception_ptr(std::runtime_error("Task was not executed")));
+            }
+        }
+
+        void operator()()
+        {
+            TaskGroup* group = std::exchange(m_group, nullptr);
+            std::exception_ptr exception;
+            try
+            {
+                m_func();
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+            group->Finish(exception);
+        }
+    };
+
+    /// <summary>
+    /// 一个任务结束，记录异常并递减计数；计数归零在互斥锁内完成，等待者返回时不会再有线程访问任务组
+    /// </summary>
+    /// <param name="exception">任务异常，可为空</param>
+    void Finish(std::exception_ptr exception) noexcept;
+
+    /// <summary>
+    /// 等待计数归零，协助执行线程池任务；工作线程上等待时休眠到有任务结束或新任务提交
+    /// </summary>
+    void WaitForIdle();
+
+private:
+    ThreadPool& m_pool;                     ///< 线程池
+    std::atomic<size_t> m_outstanding{0};   ///< 尚未结束的任务数
+    std::atomic<bool> m_failed{false};      ///< 是否已记录异常
+    std::exception_ptr m_exception;         ///< 第一个任务异常
+    HelpingWaiter m_waiter;                 ///< 计数归零通知，工作线程上等待时在线程池中休眠
+};
@@ -0,0 +1,108 @@
+﻿/// <summary>
+/// 任务执行轨迹实现文件
+/// </summary>
+#include "TaskTrace.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+namespace
+{
+    const char* const PRIORITY_NAMES[] = { "Low", "Normal", "High", "Critical" }; ///< 下标与EM_TaskPriority一致
+
+    /// <summary>
+    /// steady_clock计数差转换为微秒
+    /// </summary>
+    double TicksToMicroseconds(int64_t ticks)
+    {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::duration(ticks)).count();
+    }
+
+    /// <summary>
+    /// 输出JSON字符串，转义引号、反斜杠与控制字符
+    /// </summary>
+    void WriteJsonString(std::ostream& out, const std::string& text)
+    {
+        out << '"';
+        for (char ch : text)
+        {
+            switch (ch)
+            {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20)
+                {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(ch) << std::dec << std::setfill(' ');
+                }
+                else
+                {
+                    out << ch;
+                }
+                break;
+            }
+        }
+        out << '"';
+    }
+}
+
+void WriteChromeTrace(std::ostream& out, const std::vector<ST_TraceTrack>& tracks)
+{
+    // 以最早的入队时间为零点，避免输出巨大的绝对时间戳
+    int64_t baseTicks = INT64_MAX;
+    for (const ST_TraceTrack& track : tracks)
+    {
+        for (const ST_TraceRecord& record : track.m_records)
+        {
+            baseTicks = (std::min)(baseTicks, (std::min)(record.m_enqueueTicks, record.m_beginTicks));
+        }
+    }
+    if (baseTicks == INT64_MAX)
+    {
+        baseTicks = 0;
+    }
+
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&out, &first]()
+    {
+        if (!first)
+        {
+            out << ",\n";
+        }
+        first = false;
+    };
+
+    separator();
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ThreadPool\"}}";
+    for (const ST_TraceTrack& track : tracks)
+    {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track.m_trackId << ",\"args\":{\"name\":";
+        WriteJsonString(out, track.m_name);
+        out << "}}";
+
+        for (const ST_TraceRecord& record : track.m_records)
+        {
+            const char* priorityName = PRIORITY_NAMES[record.m_priority & 3];
+            separator();
+            out << "{\"name\":\"task\",\"cat\":\"" << priorityName << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << track.m_trackId
+                << ",\"ts\":" << TicksToMicroseconds(record.m_beginTicks - baseTicks)
+                << ",\"dur\":" << TicksToMicroseconds(record.m_endTicks - record.m_beginTicks)
+                << ",\"args\":{\"priority\":\"" << priorityName << "\""
+                << ",\"enqueue_ts\":" << TicksToMicroseconds(record.m_enqueueTicks - baseTicks)
+                << ",\"queue_wait_us\":" << TicksToMicroseconds(record.m_beginTicks - record.m_enqueueTicks) << "}}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,138 @@
+﻿/// <summary>
+/// 任务执行轨迹头文件 - 每线程无锁环形缓冲与Chrome/Perfetto轨迹导出
+/// </summary>
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../SDKCommonDefine/SDK_Export.h"
+
+/// <summary>
+/// 单个任务的执行记录，时间均为steady_clock计数
+/// </summary>
+struct ST_TraceRecord
+{
+    int64_t m_enqueueTicks{0}; ///< 入队时间
+    int64_t m_beginTicks{0};   ///< 开始执行时间
+    int64_t m_endTicks{0};     ///< 执行结束时间
+    uint32_t m_priority{0};    ///< 任务优先级（EM_TaskPriority的数值）
+};
+
+/// <summary>
+/// 单写者环形缓冲，写满后覆盖最早的记录
+/// 每个槽位带序号构成顺序锁：写者先写奇数序号再写数据，最后写偶数序号；读者前后两次读到相同的偶数序号才采用该记录，
+/// 因此读取可以与写入并发进行，写入路径只有几次普通存储，不加锁也没有读-改-写原子操作
+/// </summary>
+class TaskTraceRing
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="capacity">容量，向上取整为2的幂</param>
+    explicit TaskTraceRing(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity)
+        {
+            rounded <<= 1;
+        }
+        m_mask = rounded - 1;
+        m_slots = std::make_unique<ST_Slot[]>(rounded);
+    }
+
+    // 禁用拷贝构造和赋值
+    TaskTraceRing(const TaskTraceRing&) = delete;
+    TaskTraceRing& operator=(const TaskTraceRing&) = delete;
+
+    /// <summary>
+    /// 写入一条记录，只能由拥有者线程调用
+    /// </summary>
+    void Record(const ST_TraceRecord& record)
+    {
+        uint64_t index = m_head.load(std::memory_order_relaxed);
+        ST_Slot& slot = m_slots[index & m_mask];
+        slot.m_sequence.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.m_enqueueTicks.store(record.m_enqueueTicks, std::memory_order_relaxed);
+        slot.m_beginTicks.store(record.m_beginTicks, std::memory_order_relaxed);
+        slot.m_endTicks.store(record.m_endTicks, std::memory_order_relaxed);
+        slot.m_priority.store(record.m_priority, std::memory_order_relaxed);
+        slot.m_sequence.store(index * 2 + 2, std::memory_order_release);
+        m_head.store(index + 1, std::memory_order_release);
+    }
+
+    /// <summary>
+    /// 复制当前保留的记录（按写入顺序），可与写入并发调用；正在被覆盖的记录会被跳过
+    /// </summary>
+    /// <param name="records">输出记录，追加到末尾</param>
+    void Snapshot(std::vector<ST_TraceRecord>& records) const
+    {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t capacity = m_mask + 1;
+        uint64_t begin = head > capacity ? head - capacity : 0;
+        for (uint64_t index = begin; index < head; ++index)
+        {
+            const ST_Slot& slot = m_slots[index & m_mask];
+            uint64_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+            if (sequence != index * 2 + 2)
+            {
+                continue;
+            }
+
+            ST_TraceRecord record;
+            record.m_enqueueTicks = slot.m_enqueueTicks.load(std::memory_order_relaxed);
+            record.m_beginTicks = slot.m_beginTicks.load(std::memory_order_relaxed);
+            record.m_endTicks = slot.m_endTicks.load(std::memory_order_relaxed);
+            record.m_priority = slot.m_priority.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.m_sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                records.push_back(record);
+            }
+        }
+    }
+
+    /// <summary>
+    /// 获取累计写入的记录数（包括已被覆盖的）
+    /// </summary>
+    uint64_t GetRecordedCount() const { return m_head.load(std::memory_order_relaxed); }
+
+private:
+    /// <summary>
+    /// 槽位，字段均为原子变量以便与读者并发访问，写入使用relaxed语义，与普通存储开销相同
+    /// </summary>
+    struct ST_Slot
+    {
+        std::atomic<uint64_t> m_sequence{0};    ///< 顺序锁序号，奇数表示正在写入
+        std::atomic<int64_t> m_enqueueTicks{0}; ///< 入队时间
+        std::atomic<int64_t> m_beginTicks{0};   ///< 开始执行时间
+        std::atomic<int64_t> m_endTicks{0};     ///< 执行结束时间
+        std::atomic<uint32_t> m_priority{0};    ///< 任务优先级
+    };
+
+    std::unique_ptr<ST_Slot[]> m_slots;   ///< 槽位数组
+    uint64_t m_mask{0};                   ///< 下标掩码
+    std::atomic<uint64_t> m_head{0};      ///< 下一条记录的序号
+};
+
+/// <summary>
+/// 一条轨迹（对应轨迹查看器中的一行）
+/// </summary>
+struct ST_TraceTrack
+{
+    uint32_t m_trackId{0};                 ///< 轨迹编号，导出为tid
+    std::string m_name;                    ///< 轨迹名称
+    std::vector<ST_TraceRecord> m_records; ///< 执行记录
+};
+
+/// <summary>
+/// 把执行记录写成Chrome trace-event格式的JSON，可在chrome://tracing或Perfetto中打开
+/// 每个任务导出为一个完整事件（ph=X），参数中附带优先级与排队等待时间；时间以最早的记录为零点
+/// </summary>
+/// <param name="out">输出流</param>
+/// <param name="tracks">各条轨迹</param>
+SDK_API void WriteChromeTrace(std::ostream& out, const std::vector<ST_TraceTrack>& tracks);
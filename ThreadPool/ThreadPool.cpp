@@ -1,5 +1,330 @@
 ﻿#include "ThreadPool.h"
+#include "TimerWheel.h"
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    thread_local ThreadPool* t_currentPool = nullptr;      ///< 当前线程所属线程池
+    thread_local ST_WorkerSlot* t_currentSlot = nullptr;   ///< 当前工作线程槽位
+    thread_local uint32_t t_stealSeed = 0;                 ///< 窃取时选择受害者的随机种子
+    thread_local size_t t_statsShard = SIZE_MAX;           ///< 非工作线程使用的提交分片下标
+    thread_local size_t t_blockingDepth = 0;               ///< 当前线程ScopedBlocking的嵌套层数
+    thread_local size_t t_submitShardCursor = 0;           ///< 取提交分片时的轮转起点
+    std::atomic<size_t> g_nextStatsShard{0};               ///< 按线程轮流分配提交分片
+    std::atomic<uint64_t> g_nextPoolId{1};                 ///< 下一个线程池编号
+
+    /// <summary>
+    /// 非工作线程在各线程池中的本地状态缓存，线程退出时释放占用的实例
+    /// </summary>
+    struct ST_ExternalThreadCache
+    {
+        /// <summary>
+        /// 一个线程池中的本地状态
+        /// </summary>
+        struct ST_Entry
+        {
+            uint64_t m_poolId;                                      ///< 线程池编号
+            std::weak_ptr<ST_ExternalThreadRegistry> m_registry;    ///< 线程池的登记表，线程池析构后失效
+            ST_ExternalThreadState* m_state;                        ///< 占用的实例
+        };
+
+        std::vector<ST_Entry> m_entries; ///< 所有访问过的线程池
+
+        ~ST_ExternalThreadCache();
+    };
+
+    thread_local ST_ExternalThreadCache t_externalThreads;  ///< 当前线程的本地状态缓存
+    thread_local bool t_externalThreadsDestroyed = false;   ///< 本地状态缓存已随线程退出销毁
+    thread_local uint64_t t_lastPoolId = 0;                 ///< 最近访问的线程池编号，快速路径只读这两个平凡的线程局部变量
+    thread_local ST_ExternalThreadState* t_lastExternalState = nullptr; ///< 最近访问的线程池中的本地状态
+
+    ST_ExternalThreadCache::~ST_ExternalThreadCache()
+    {
+        for (ST_Entry& entry : m_entries)
+        {
+            // 持有登记表期间实例不会被释放，线程池析构与线程退出同时发生也是安全的
+            if (std::shared_ptr<ST_ExternalThreadRegistry> registry = entry.m_registry.lock())
+            {
+                entry.m_state->m_inUse.store(false, std::memory_order_release);
+            }
+        }
+        t_externalThreadsDestroyed = true;
+        t_lastPoolId = 0;
+    }
+
+    /// <summary>
+    /// 获取当前非工作线程使用的提交分片下标
+    /// </summary>
+    size_t CurrentExternalShard()
+    {
+        if (t_statsShard == SIZE_MAX)
+        {
+            t_statsShard = g_nextStatsShard.fetch_add(1, std::memory_order_relaxed);
+        }
+        return t_statsShard;
+    }
+
+    /// <summary>
+    /// 直方图转换为微秒单位的摘要
+    /// </summary>
+    ST_LatencySummary SummarizeHistogram(const LatencyHistogram& histogram)
+    {
+        ST_LatencySummary summary;
+        summary.m_count = histogram.Count();
+        summary.m_avgUs = histogram.Mean() / 1000.0;
+        summary.m_p50Us = histogram.Percentile(0.50) / 1000.0;
+        summary.m_p99Us = histogram.Percentile(0.99) / 1000.0;
+        summary.m_p999Us = histogram.Percentile(0.999) / 1000.0;
+        summary.m_maxUs = histogram.Max() / 1000.0;
+        return summary;
+    }
+
+    constexpr size_t PAUSES_PER_ROUND = 8;   ///< 每轮自旋的pause指令数
+    constexpr size_t MAX_POP_BATCH = 16;     ///< 从共享队列一次取出的任务数上限
+
+    /// <summary>
+    /// 调度配置档对应的参数
+    /// </summary>
+    struct ST_ProfileParams
+    {
+        size_t m_minSpinRounds;     ///< 最少自旋轮数
+        size_t m_maxSpinRounds;     ///< 最多自旋轮数，0表示不自旋直接休眠
+        size_t m_wakeBatch;         ///< 有线程自旋时，积压多少次提交才额外唤醒一个休眠线程
+        size_t m_popBatch;          ///< 从共享队列一次取出的任务数上限
+        size_t m_dedicatedSpins;    ///< 专用线程邮箱为空时休眠前的自旋次数
+        std::chrono::milliseconds m_timerSlack; ///< 定时器唤醒合并间隔
+    };
+
+    /// <summary>
+    /// 各配置档参数，下标与EM_SchedulingProfile一致；LowLatency的自旋轮数上下限相同，自旋不随空闲减少
+    /// </summary>
+    constexpr ST_ProfileParams PROFILE_PARAMS[] = {
+        { 16, 1024, 1, 1, 2048, std::chrono::milliseconds(0) },     // Balanced
+        { 8192, 8192, 1, 1, 65536, std::chrono::milliseconds(0) },  // LowLatency
+        { 16, 1024, 8, 8, 2048, std::chrono::milliseconds(0) },     // Throughput
+        { 0, 0, 1, 1, 0, std::chrono::milliseconds(16) },           // Efficiency
+    };
+
+    /// <summary>
+    /// 获取配置档参数
+    /// </summary>
+    const ST_ProfileParams& ProfileParams(EM_SchedulingProfile profile)
+    {
+        return PROFILE_PARAMS[static_cast<size_t>(profile) & 3];
+    }
+
+    /// <summary>
+    /// 自旋等待时提示CPU降低功耗并让出流水线资源
+    /// </summary>
+    inline void CpuRelax()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    /// <summary>
+    /// 当前线程绑定到指定的CPU集合
+    /// </summary>
+    /// <param name="cpus">CPU编号</param>
+    /// <returns>是否绑定成功，不支持的平台返回false</returns>
+    bool PinCurrentThreadToCpus(const std::vector<int>& cpus)
+    {
+#ifdef _WIN32
+        // SetThreadAffinityMask只能表示当前处理器组内的CPU
+        DWORD_PTR mask = 0;
+        for (int cpu : cpus)
+        {
+            if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+            {
+                mask |= static_cast<DWORD_PTR>(1) << cpu;
+            }
+        }
+        return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        bool any = false;
+        for (int cpu : cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &cpuSet);
+                any = true;
+            }
+        }
+        return any && pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+
+    /// <summary>
+    /// 设置当前线程名称，便于在调试器、top -H与性能分析工具中识别
+    /// </summary>
+    /// <param name="name">线程名称（UTF-8）</param>
+    void SetCurrentThreadName(const std::string& name)
+    {
+#ifdef _WIN32
+        int length = MultiByteToWideChar(CP_UTF8, 0, name.c_str(), -1, nullptr, 0);
+        if (length > 0)
+        {
+            std::wstring wideName(static_cast<size_t>(length), L'\0');
+            MultiByteToWideChar(CP_UTF8, 0, name.c_str(), -1, &wideName[0], length);
+            SetThreadDescription(GetCurrentThread(), wideName.c_str());
+        }
+#elif defined(__linux__)
+        // Linux线程名最长15字节，截断时不能切开UTF-8多字节字符
+        size_t length = (std::min)(name.size(), static_cast<size_t>(15));
+        while (length > 0 && length < name.size() && (static_cast<unsigned char>(name[length]) & 0xC0) == 0x80)
+        {
+            --length;
+        }
+        pthread_setname_np(pthread_self(), name.substr(0, length).c_str());
+#else
+        (void)name;
+#endif
+    }
+
+    /// <summary>
+    /// 获取当前线程正在运行的CPU编号
+    /// </summary>
+    /// <returns>CPU编号，不支持的平台返回-1</returns>
+    int CurrentCpu()
+    {
+#ifdef _WIN32
+        return static_cast<int>(GetCurrentProcessorNumber());
+#elif defined(__linux__)
+        return sched_getcpu();
+#else
+        return -1;
+#endif
+    }
+
+    /// <summary>
+    /// 解析Linux的CPU列表格式，例如"0-15,32-47"
+    /// </summary>
+    std::vector<int> ParseCpuList(const std::string& text)
+    {
+        std::vector<int> cpus;
+        std::stringstream stream(text);
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            if (range.empty() || range == "\n")
+            {
+                continue;
+            }
+            size_t dash = range.find('-');
+            int first = std::atoi(range.c_str());
+            int last = dash == std::string::npos ? first : std::atoi(range.c_str() + dash + 1);
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    /// <summary>
+    /// 检测NUMA拓扑
+    /// </summary>
+    /// <returns>各节点包含的CPU编号；无法检测时返回包含所有CPU的单个节点</returns>
+    std::vector<std::vector<int>> DetectNumaNodes()
+    {
+        std::vector<std::vector<int>> nodes;
+#ifdef _WIN32
+        ULONG highestNode = 0;
+        if (GetNumaHighestNodeNumber(&highestNode))
+        {
+            for (ULONG node = 0; node <= highestNode; ++node)
+            {
+                // 只处理第0个处理器组，与SetThreadAffinityMask的范围一致
+                GROUP_AFFINITY affinity = {};
+                if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity) || affinity.Group != 0)
+                {
+                    continue;
+                }
+                std::vector<int> cpus;
+                for (int cpu = 0; cpu < static_cast<int>(sizeof(KAFFINITY) * 8); ++cpu)
+                {
+                    if (affinity.Mask & (static_cast<KAFFINITY>(1) << cpu))
+                    {
+                        cpus.push_back(cpu);
+                    }
+                }
+                if (!cpus.empty())
+                {
+                    nodes.push_back(std::move(cpus));
+                }
+            }
+        }
+#elif defined(__linux__)
+        // 节点编号可能不连续，逐个尝试
+        for (int node = 0; node < 1024; ++node)
+        {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!file)
+            {
+                continue;
+            }
+            std::string text;
+            std::getline(file, text);
+            std::vector<int> cpus = ParseCpuList(text);
+            if (!cpus.empty())
+            {
+                nodes.push_back(std::move(cpus));
+            }
+        }
+#endif
+        if (nodes.empty())
+        {
+            std::vector<int> cpus;
+            for (unsigned int cpu = 0; cpu < (std::max)(std::thread::hardware_concurrency(), 1u); ++cpu)
+            {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+            nodes.push_back(std::move(cpus));
+        }
+        return nodes;
+    }
+
+    /// <summary>
+    /// xorshift随机数，用于随机选择窃取目标
+    /// </summary>
+    uint32_t NextStealRandom()
+    {
+        if (t_stealSeed == 0)
+        {
+            t_stealSeed = static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) | 1u;
+        }
+        t_stealSeed ^= t_stealSeed << 13;
+        t_stealSeed ^= t_stealSeed >> 17;
+        t_stealSeed ^= t_stealSeed << 5;
+        return t_stealSeed;
+    }
+}
 
 ThreadPool::ThreadPool(const ST_ThreadPoolConfig& config)
     : m_config(config)
@@ -8,11 +333,33 @@ ThreadPool::ThreadPool(const ST_ThreadPoolConfig& config)
     , m_activeThreads(0)
     , m_adjusting(false)
     , m_nextThreadId(0)
+    , m_workerSlots(std::make_unique<ST_WorkerSlot[]>(MAX_WORKER_SLOTS))
+    , m_poolId(g_nextPoolId.fetch_add(1, std::memory_order_relaxed))
+    , m_externalThreads(std::make_shared<ST_ExternalThreadRegistry>())
 {
-    for (size_t i = 0; i < m_config.m_minThreads; ++i)
+    m_tasks.configure(m_config.m_priorityPolicy, std::chrono::milliseconds(m_config.m_agingThreshold));
+    m_overloadPolicy.store(m_config.m_overloadPolicy, std::memory_order_relaxed);
+    m_overloadTimeoutMs.store(static_cast<int64_t>(m_config.m_overloadTimeout), std::memory_order_relaxed);
+    m_residentWorkers.store((std::clamp)(m_config.m_minThreads, static_cast<size_t>(1), MAX_WORKER_SLOTS), std::memory_order_relaxed);
+    m_profile.store(m_config.m_schedulingProfile, std::memory_order_relaxed);
+    ConfigurePlacement();
+
+    size_t shardCount = m_config.m_submitShards;
+    if (shardCount == 0)
     {
-        CreateWorkerThread();
+        shardCount = (std::min)(static_cast<size_t>((std::max)(std::thread::hardware_concurrency(), 1u)), MAX_SUBMIT_SHARDS);
+    }
+    if (shardCount > 1)
+    {
+        for (size_t i = 0; i < shardCount; ++i)
+        {
+            auto shard = std::make_unique<PriorityTaskQueue>(SIZE_MAX, SUBMIT_SHARD_LANE_CAPACITY);
+            shard->configure(m_config.m_priorityPolicy, std::chrono::milliseconds(m_config.m_agingThreshold));
+            m_submitShards.push_back(std::move(shard));
+        }
     }
+    ApplyQueueLimits(m_config.m_maxQueueSize);
+    AdjustThreadCount();
 }
 
 ThreadPool::~ThreadPool()
@@ -29,7 +376,7 @@ ThreadPool::~ThreadPool()
     // 清理所有专用线程
     std::vector<std::shared_ptr<ST_DedicatedThreadInfo>> threadsToStop;
     {
-        std::lock_guard<std::mutex> lock(m_dedicatedThreadsMutex);
+        std::shared_lock<std::shared_mutex> lock(m_dedicatedThreadsMutex);
         for (const auto& pair : m_dedicatedThreads)
         {
             threadsToStop.push_back(pair.second);
@@ -38,15 +385,7 @@ ThreadPool::~ThreadPool()
 
     for (auto& threadInfo : threadsToStop)
     {
-        {
-            std::lock_guard<std::mutex> lock(threadInfo->m_mutex);
-            threadInfo->m_stop = true;
-        }
-        threadInfo->m_condition.notify_all();
-        if (threadInfo->m_thread.joinable())
-        {
-            threadInfo->m_thread.join();
-        }
+        JoinDedicatedThread(*threadInfo);
     }
 }
 
@@ -68,6 +407,7 @@ void ThreadPool::Resize(size_t minThreads, size_t maxThreads)
         m_config.m_minThreads = minThreads;
         m_config.m_maxThreads = maxThreads;
     }
+    m_residentWorkers.store((std::clamp)(minThreads, static_cast<size_t>(1), MAX_WORKER_SLOTS), std::memory_order_relaxed);
 
     AdjustThreadCount();
     m_adjusting.store(false);
@@ -75,18 +415,77 @@ void ThreadPool::Resize(size_t minThreads, size_t maxThreads)
 
 void ThreadPool::WaitAll()
 {
-    const auto timeout = std::chrono::milliseconds(100);
-    while (true)
+    // 当前任务本身计入未完成任务数，在工作线程上等待永远不会返回
+    if (IsWorkerThread())
     {
-        if (m_tasks.empty() && (m_activeThreads.load() == 0) || m_stop)
+        throw std::logic_error("ThreadPool::WaitAll cannot be called from a pool task");
+    }
+
+    auto isIdle = [this]() { return GetOutstandingTaskCount() == 0 || m_stop; };
+    while (!isIdle())
+    {
+        // 先协助执行队列中的任务，队列为空时再休眠等待最后一个任务结束
+        if (RunPendingTask())
         {
-            break;
+            continue;
+        }
+
+        // 先登记等待者再检查计数，与FinishTasks中先计入完成再检查等待者配对，两边至少有一方看到对方
+        m_idleWaiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_idleCondition.wait(lock, isIdle);
         }
-        
-        std::this_thread::sleep_for(timeout);
+        m_idleWaiters.fetch_sub(1);
+    }
+}
+
+TimerId ThreadPool::AddTimer(std::chrono::steady_clock::time_point when, std::chrono::steady_clock::duration period, TaskFunction func, EM_TaskPriority priority)
+{
+    std::call_once(m_timerWheelOnce, [this]()
+    {
+        std::lock_guard<std::mutex> lock(m_timerSlackMutex);
+        m_timerWheel = std::make_unique<TimerWheel>(*this);
+        m_timerWheel->SetSlack(ProfileParams(m_profile.load(std::memory_order_relaxed)).m_timerSlack);
+    });
+    if (!m_timerWheel)
+    {
+        throw std::runtime_error("ThreadPool is stopped");
+    }
+    return m_timerWheel->Add(when, period, std::move(func), priority);
+}
+
+bool ThreadPool::CancelTimer(TimerId id)
+{
+    std::call_once(m_timerWheelOnce, []() {});
+    return m_timerWheel ? m_timerWheel->Cancel(id) : false;
+}
+
+bool ThreadPool::IsWorkerThread() const
+{
+    return t_currentPool == this;
+}
+
+void ThreadPool::FinishTasks(size_t count)
+{
+    // 只写当前线程的统计实例，执行路径上不再争用线程池级别的计数；没有等待者时不汇总
+    CurrentStats().m_finishedTasks.fetch_add(count);
+    if (m_idleWaiters.load() > 0 && GetOutstandingTaskCount() == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idleCondition.notify_all();
     }
 }
 
+uint64_t ThreadPool::GetOutstandingTaskCount() const
+{
+    uint64_t finished = 0;
+    ForEachStats([&finished](const ST_ThreadStats& threadStats) { finished += threadStats.m_finishedTasks.load(); });
+    uint64_t enqueued = 0;
+    ForEachStats([&enqueued](const ST_ThreadStats& threadStats) { enqueued += threadStats.m_enqueuedTasks.load(); });
+    return enqueued - finished;
+}
+
 void ThreadPool::Shutdown()
 {
     // 设置停止标志，不需要锁，因为是原子操作
@@ -96,18 +495,77 @@ void ThreadPool::Shutdown()
         return;  // 已经在关闭过程中
     }
 
+    // 先停止定时线程，未到期的定时器直接丢弃；消耗创建标志，之后不会再创建时间轮
+    std::call_once(m_timerWheelOnce, []() {});
+    if (m_timerWheel)
+    {
+        m_timerWheel->Stop();
+    }
+
     // 清理任务队列
     ST_Task task;
-    while (m_tasks.try_pop(task)) {} // 清空队列
+    size_t droppedCount = 0;
+    while (m_tasks.try_pop(task))
+    {
+        ++droppedCount;
+    }
+    for (auto& shard : m_submitShards)
+    {
+        while (shard->try_pop(task))
+        {
+            ++droppedCount;
+        }
+    }
+    for (auto& nodeQueue : m_nodeQueues)
+    {
+        while (nodeQueue->try_pop(task))
+        {
+            ++droppedCount;
+        }
+    }
+    size_t slotCount = m_workerSlotHighWater.load(std::memory_order_acquire);
+    for (size_t i = 0; i < slotCount; ++i)
+    {
+        PriorityTaskQueue* inbox = m_workerSlots[i].m_inbox.load(std::memory_order_acquire);
+        while (inbox != nullptr && inbox->try_pop(task))
+        {
+            ++droppedCount;
+        }
+    }
+    task.m_func = nullptr;
+    if (droppedCount > 0)
+    {
+        FinishTasks(droppedCount);
+    }
 
-    // 通知所有等待的线程
-    m_condition.notify_all();
+    // 停止线程数控制器，之后不会再创建工作线程
+    std::thread monitor;
+    {
+        std::lock_guard<std::mutex> lock(m_workersMutex);
+        monitor.swap(m_monitorThread);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_monitorMutex);
+        m_monitorCondition.notify_all();
+    }
+    if (monitor.joinable())
+    {
+        monitor.join();
+    }
+
+    // 唤醒所有休眠的线程以及WaitAll中的等待者
+    WakeAllWorkers();
+    {
+        std::lock_guard<std::mutex> lock(m_idleMutex);
+        m_idleCondition.notify_all();
+    }
 
     // 逐个清理线程
     std::vector<std::thread> workers_to_join;
     {
         std::lock_guard<std::mutex> lock(m_workersMutex);
         workers_to_join.swap(m_workers);
+        m_exitedWorkers.clear();
     }
 
     // 在没有持有锁的情况下等待线程结束
@@ -125,126 +583,1776 @@ void ThreadPool::Shutdown()
     m_adjusting = false;
 }
 
-void ThreadPool::WorkerThread()
+EM_SubmitStatus ThreadPool::SubmitTask(ST_Task& task, size_t workerIndex)
 {
-    while (true)
+    if (m_stop.load(std::memory_order_acquire))
     {
-        ST_Task task;
-        bool hasTask = false;
+        return EM_SubmitStatus::Stopped;
+    }
 
-        // 使用较短的超时时间等待任务
-        {
-            std::shared_lock<std::shared_mutex> configLock(m_configMutex);
-            auto timeout = std::chrono::milliseconds(m_config.m_keepAliveTime);
-            configLock.unlock();
+    if (PushTask(std::move(task), workerIndex))
+    {
+        return EM_SubmitStatus::Accepted;
+    }
 
-            auto startWait = std::chrono::steady_clock::now();
-            while (!m_stop)
+    switch (m_overloadPolicy.load(std::memory_order_relaxed))
+    {
+    case EM_OverloadPolicy::Block:
+    {
+        m_blockedCount.fetch_add(1, std::memory_order_relaxed);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_overloadTimeoutMs.load(std::memory_order_relaxed));
+        while (true)
+        {
+            if (m_stop.load(std::memory_order_acquire))
             {
-                if (m_tasks.try_pop(task))
-                {
-                    hasTask = true;
-                    break;
-                }
-
-                if (std::chrono::steady_clock::now() - startWait > timeout)
-                {
-                    break;
-                }
+                return EM_SubmitStatus::Stopped;
+            }
+            if (PushTask(std::move(task), workerIndex))
+            {
+                return EM_SubmitStatus::Accepted;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                CurrentStats().Priority(task.m_priority).m_rejected.fetch_add(1, std::memory_order_relaxed);
+                return EM_SubmitStatus::Timeout;
+            }
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            // 协助消化队列，腾出空位；没有可执行的任务时短暂休眠
+            if (!RunPendingTask())
+            {
+                std::this_thread::sleep_for(OVERLOAD_BLOCK_SLEEP);
             }
         }
+    }
 
-        // 检查停止信号
-        if (m_stop)
+    case EM_OverloadPolicy::CallerRuns:
+    {
+        m_callerRunsCount.fetch_add(1, std::memory_order_relaxed);
+        ST_Task running = std::move(task);
+        try
         {
-            --m_totalThreads;
-            return;
+            running.m_func();
         }
+        catch (...) {}
+        return EM_SubmitStatus::CallerRan;
+    }
 
-        // 检查空闲超时
-        if (!hasTask)
+    case EM_OverloadPolicy::DropOldestLowest:
+    {
+        // 每挤出一个旧任务重试一次；没有优先级不高于新任务的旧任务可挤出时丢弃新任务，经PostOrRun投递的内部任务不会被挤出
+        // 新任务进入提交者所在的分片或目标线程的收件箱，因此优先从同一队列中挤出旧任务
+        ST_Task victim;
+        auto popVictim = [this, &task, &victim, workerIndex]()
         {
-            std::shared_lock<std::shared_mutex> configLock(m_configMutex);
-            if (m_totalThreads > m_config.m_minThreads)
+            if (workerIndex != SIZE_MAX)
             {
-                --m_totalThreads;
-                return;
+                PriorityTaskQueue* inbox = m_workerSlots[workerIndex].m_inbox.load(std::memory_order_acquire);
+                if (inbox != nullptr && inbox->try_pop_lowest(task.m_priority, victim))
+                {
+                    return true;
+                }
+            }
+            if (!m_submitShards.empty() && task.m_priority <= EM_TaskPriority::Normal
+                && m_submitShards[CurrentExternalShard() % m_submitShards.size()]->try_pop_lowest(task.m_priority, victim))
+            {
+                return true;
+            }
+            return m_tasks.try_pop_lowest(task.m_priority, victim);
+        };
+        while (popVictim())
+        {
+            victim.m_func = nullptr;
+            FinishTasks(1);
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            if (PushTask(std::move(task), workerIndex))
+            {
+                return EM_SubmitStatus::Accepted;
             }
-            continue;
         }
+        // 查找过程中被移到通道末尾的内部任务可能错过了工作线程的检查
+        WakeOneWorker();
+        CurrentStats().Priority(task.m_priority).m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return EM_SubmitStatus::Rejected;
+    }
 
-        // 执行任务
-        try
+    default:
+        CurrentStats().Priority(task.m_priority).m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return EM_SubmitStatus::Rejected;
+    }
+}
+
+EM_SubmitStatus ThreadPool::SubmitTasks(std::span<ST_Task> tasks, size_t& accepted)
+{
+    accepted = 0;
+    if (m_stop.load(std::memory_order_acquire))
+    {
+        return EM_SubmitStatus::Stopped;
+    }
+
+    // 队列剩余空间不足时，放不下的任务逐个提交，由过载策略决定等待、就地执行或丢弃
+    EM_SubmitStatus result = EM_SubmitStatus::Accepted;
+    accepted = PushTasks(tasks);
+    for (size_t i = accepted; i < tasks.size(); ++i)
+    {
+        EM_SubmitStatus status = SubmitTask(tasks[i]);
+        if (status == EM_SubmitStatus::Accepted || status == EM_SubmitStatus::CallerRan)
         {
-            ++m_activeThreads;
-            task.m_func();
+            ++accepted;
         }
-        catch (...) {}
-        --m_activeThreads;
-
-        // 只在非停止状态下调整线程数
-        if (!m_stop && !m_adjusting)
+        if (status == EM_SubmitStatus::Stopped)
         {
-            AdjustThreadCount();
+            return status;
+        }
+        if (status == EM_SubmitStatus::Rejected || status == EM_SubmitStatus::Timeout)
+        {
+            if (result == EM_SubmitStatus::Accepted || result == EM_SubmitStatus::CallerRan)
+            {
+                result = status;
+            }
+        }
+        else if (status == EM_SubmitStatus::CallerRan && result == EM_SubmitStatus::Accepted)
+        {
+            result = status;
         }
     }
+    return result;
 }
 
-void ThreadPool::AdjustThreadCount()
+void ThreadPool::ThrowOnSubmitFailure(EM_SubmitStatus status) const
 {
-    std::shared_lock<std::shared_mutex> configLock(m_configMutex);
-    size_t currentThreads = m_totalThreads;
-    size_t pendingTasks = m_tasks.size();
-    size_t activeThreads = m_activeThreads;
-    size_t minThreads = m_config.m_minThreads;
-    size_t maxThreads = m_config.m_maxThreads;
-    configLock.unlock();
-
-    // 增加线程
-    if (pendingTasks > activeThreads && currentThreads < maxThreads)
+    switch (status)
     {
-        size_t threadsToAdd = std::min(
-            maxThreads - currentThreads,
-            pendingTasks - activeThreads
-        );
+    case EM_SubmitStatus::Stopped:
+        throw std::runtime_error("ThreadPool is stopped");
 
-        for (size_t i = 0; i < threadsToAdd; ++i)
+    case EM_SubmitStatus::Rejected:
+    case EM_SubmitStatus::Timeout:
+    {
+        EM_OverloadPolicy policy = m_overloadPolicy.load(std::memory_order_relaxed);
+        if (policy == EM_OverloadPolicy::Throw || policy == EM_OverloadPolicy::Block)
         {
-            CreateWorkerThread();
+            throw std::runtime_error("Task queue is full");
         }
+        break;
     }
-    // 减少线程
-    else if (currentThreads > minThreads && activeThreads < currentThreads / 2)
-    {
-        // 通过条件变量通知来自然减少线程数
-        m_condition.notify_all();
+
+    default:
+        break;
     }
 }
 
-void ThreadPool::CreateWorkerThread()
+void ThreadPool::SetOverloadPolicy(EM_OverloadPolicy policy, std::chrono::milliseconds timeout)
 {
-    std::lock_guard<std::mutex> lock(m_workersMutex);
-    ++m_totalThreads;
-    m_workers.emplace_back(&ThreadPool::WorkerThread, this);
+    {
+        std::unique_lock<std::shared_mutex> lock(m_configMutex);
+        m_config.m_overloadPolicy = policy;
+        m_config.m_overloadTimeout = static_cast<size_t>(timeout.count());
+    }
+    m_overloadTimeoutMs.store(timeout.count(), std::memory_order_relaxed);
+    m_overloadPolicy.store(policy, std::memory_order_relaxed);
 }
 
-size_t ThreadPool::CreateDedicatedThread(const std::string& name, std::function<void()> task)
+void ThreadPool::SetMaxQueueSize(size_t maxQueueSize)
 {
-    auto threadInfo = std::make_shared<ST_DedicatedThreadInfo>();
-    threadInfo->m_name = name;
-    threadInfo->m_task = std::move(task);
-    threadInfo->m_state = EM_DedicatedThreadState::Running;
-    threadInfo->m_stop = false;
-
-    size_t threadId = m_nextThreadId++;
     {
-        std::lock_guard<std::mutex> lock(m_dedicatedThreadsMutex);
-        m_dedicatedThreads[threadId] = threadInfo;
+        std::unique_lock<std::shared_mutex> lock(m_configMutex);
+        m_config.m_maxQueueSize = maxQueueSize;
     }
+    ApplyQueueLimits(maxQueueSize);
+}
 
-    threadInfo->m_thread = std::thread(&ThreadPool::DedicatedThreadWorker, this, threadInfo);
+void ThreadPool::ApplyQueueLimits(size_t maxQueueSize)
+{
+    // 分区本地队列与提交分片各占前置队列份额的一部分；份额不足时单个队列上限可以为0，任务直接进入全局队列
+    size_t groupCount = (m_nodeQueues.empty() ? 0 : 1) + (m_submitShards.empty() ? 0 : 1);
+    size_t groupBudget = groupCount > 0 ? maxQueueSize / 2 / groupCount : 0;
+    size_t frontCapacity = 0;
+    for (auto& nodeQueue : m_nodeQueues)
+    {
+        nodeQueue->set_max_size(groupBudget / m_nodeQueues.size());
+        frontCapacity += groupBudget / m_nodeQueues.size();
+    }
+    for (auto& shard : m_submitShards)
+    {
+        shard->set_max_size(groupBudget / m_submitShards.size());
+        frontCapacity += groupBudget / m_submitShards.size();
+    }
+    m_tasks.set_max_size(maxQueueSize - frontCapacity);
+}
+
+void ThreadPool::SetSchedulingProfile(EM_SchedulingProfile profile)
+{
+    {
+        std::unique_lock<std::shared_mutex> lock(m_configMutex);
+        m_config.m_schedulingProfile = profile;
+    }
+    m_profile.store(profile, std::memory_order_relaxed);
+    m_submitsSinceWake.store(0, std::memory_order_relaxed);
+
+    // 时间轮尚未创建时，创建时按当前配置档设置
+    std::lock_guard<std::mutex> lock(m_timerSlackMutex);
+    if (m_timerWheel)
+    {
+        m_timerWheel->SetSlack(ProfileParams(m_profile.load(std::memory_order_relaxed)).m_timerSlack);
+    }
+}
+
+ST_OverloadStats ThreadPool::GetOverloadStats() const
+{
+    ST_OverloadStats stats;
+    ForEachStats([&stats](const ST_ThreadStats& threadStats)
+    {
+        for (const auto& counters : threadStats.m_priorities)
+        {
+            stats.m_rejected += counters.m_rejected.load(std::memory_order_relaxed);
+        }
+    });
+    stats.m_dropped = m_droppedCount.load(std::memory_order_relaxed);
+    stats.m_callerRuns = m_callerRunsCount.load(std::memory_order_relaxed);
+    stats.m_blocked = m_blockedCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool ThreadPool::PushTask(ST_Task&& task, size_t workerIndex)
+{
+    // 入队前计数，保证任务执行结束时计入的完成数不会早于入队数
+    ST_ThreadStats& stats = CurrentStats();
+    stats.m_enqueuedTasks.fetch_add(1, std::memory_order_relaxed);
+    ST_ThreadStats::ST_PriorityCounters& counters = stats.Priority(task.m_priority);
+
+    // 定向任务进入目标线程的收件箱；槽位当前没有工作线程时按普通任务处理
+    if (workerIndex != SIZE_MAX && m_workerSlots[workerIndex].m_inUse.load())
+    {
+        ST_WorkerSlot& target = m_workerSlots[workerIndex];
+        if (!WorkerInbox(target).try_push(std::move(task)))
+        {
+            FinishTasks(1);
+            return false;
+        }
+        counters.m_submitted.fetch_add(1, std::memory_order_relaxed);
+        WakeWorker(&target);
+
+        // 入队后槽位被释放时，释放者可能已经清空过收件箱，唤醒其他线程接管
+        if (!target.m_inUse.load())
+        {
+            WakeOneWorker(true);
+        }
+        return true;
+    }
+
+    // 高优先级任务始终进入全局队列，避免被困在某个工作线程的本地队列后面
+    if (m_config.m_schedulerMode == EM_SchedulerMode::WorkStealing && t_currentPool == this && t_currentSlot != nullptr
+        && task.m_priority <= EM_TaskPriority::Normal)
+    {
+        try
+        {
+            t_currentSlot->m_localTasks.Push(CreatePooledTask(std::move(task)));
+        }
+        catch (...)
+        {
+            FinishTasks(1);
+            throw;
+        }
+        counters.m_submitted.fetch_add(1, std::memory_order_relaxed);
+        // 本地任务只能被窃取，自旋线程不一定会选中该队列，因此总是唤醒一个休眠线程
+        WakeOneWorker(true);
+        return true;
+    }
+
+    // 普通及以下优先级任务进入提交者所在分区的本地队列，由同一NUMA节点上的工作线程执行
+    if (!m_nodeQueues.empty() && task.m_priority <= EM_TaskPriority::Normal)
+    {
+        size_t node = CurrentNode();
+        if (node < m_nodeQueues.size() && m_nodeQueues[node]->try_push(std::move(task)))
+        {
+            counters.m_submitted.fetch_add(1, std::memory_order_relaxed);
+            WakeForSubmit(node);
+            return true;
+        }
+    }
+
+    // 其余普通及以下优先级任务按提交线程分散到提交分片，大量生产者不再争用全局队列的同一个队尾
+    if (!m_submitShards.empty() && task.m_priority <= EM_TaskPriority::Normal
+        && m_submitShards[CurrentExternalShard() % m_submitShards.size()]->try_push(std::move(task)))
+    {
+        counters.m_submitted.fetch_add(1, std::memory_order_relaxed);
+        WakeForSubmit();
+        return true;
+    }
+
+    if (!m_tasks.try_push(std::move(task)))
+    {
+        FinishTasks(1);
+        return false;
+    }
+    counters.m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+    WakeForSubmit();
+    return true;
+}
+
+size_t ThreadPool::PushTasks(std::span<ST_Task> tasks)
+{
+    if (tasks.empty())
+    {
+        return 0;
+    }
+
+    // 入队前整批计数，保证任务执行结束时计入的完成数不会早于入队数
+    CurrentStats().m_enqueuedTasks.fetch_add(tasks.size(), std::memory_order_relaxed);
+    EM_TaskPriority priority = tasks.front().m_priority;
+    size_t pushed = 0;
+
+    // 路由与PushTask一致：工作线程上提交的普通及以下优先级任务进入本地队列，压入只需普通存储
+    if (m_config.m_schedulerMode == EM_SchedulerMode::WorkStealing && t_currentPool == this && t_currentSlot != nullptr
+        && priority <= EM_TaskPriority::Normal)
+    {
+        try
+        {
+            for (; pushed < tasks.size(); ++pushed)
+            {
+                t_currentSlot->m_localTasks.Push(CreatePooledTask(std::move(tasks[pushed])));
+            }
+        }
+        catch (...)
+        {
+            FinishTasks(tasks.size() - pushed);
+            if (pushed > 0)
+            {
+                CurrentStats().Priority(priority).m_submitted.fetch_add(pushed, std::memory_order_relaxed);
+                WakeForBulkSubmit(pushed, true);
+            }
+            throw;
+        }
+        CurrentStats().Priority(priority).m_submitted.fetch_add(pushed, std::memory_order_relaxed);
+        WakeForBulkSubmit(pushed, true);
+        return pushed;
+    }
+
+    size_t node = SIZE_MAX;
+    if (!m_nodeQueues.empty() && priority <= EM_TaskPriority::Normal)
+    {
+        node = CurrentNode();
+        if (node < m_nodeQueues.size())
+        {
+            pushed += m_nodeQueues[node]->try_push_bulk(priority, tasks);
+        }
+    }
+    if (pushed < tasks.size() && !m_submitShards.empty() && priority <= EM_TaskPriority::Normal)
+    {
+        pushed += m_submitShards[CurrentExternalShard() % m_submitShards.size()]->try_push_bulk(priority, tasks.subspan(pushed));
+    }
+    if (pushed < tasks.size())
+    {
+        pushed += m_tasks.try_push_bulk(priority, tasks.subspan(pushed));
+    }
+
+    if (pushed < tasks.size())
+    {
+        FinishTasks(tasks.size() - pushed);
+    }
+    if (pushed > 0)
+    {
+        CurrentStats().Priority(priority).m_submitted.fetch_add(pushed, std::memory_order_relaxed);
+        WakeForBulkSubmit(pushed, false, node);
+    }
+    return pushed;
+}
+
+ST_ThreadStats& ThreadPool::CurrentStats()
+{
+    if (t_currentPool == this && t_currentSlot != nullptr)
+    {
+        return *t_currentSlot->m_stats.load(std::memory_order_relaxed);
+    }
+
+    return CurrentExternalState().m_stats;
+}
+
+ST_ExternalThreadState& ThreadPool::CurrentExternalState()
+{
+    if (t_lastPoolId == m_poolId)
+    {
+        return *t_lastExternalState;
+    }
+
+    // 线程退出过程中（如其他线程本地对象的析构函数里提交任务）缓存已经销毁，只能使用共享实例
+    if (t_externalThreadsDestroyed)
+    {
+        return m_externalThreads->m_shared;
+    }
+
+    ST_ExternalThreadCache& cache = t_externalThreads;
+    // 顺便清理已析构线程池的条目
+    ST_ExternalThreadState* state = nullptr;
+    auto it = cache.m_entries.begin();
+    while (it != cache.m_entries.end())
+    {
+        if (it->m_poolId == m_poolId)
+        {
+            state = it->m_state;
+            ++it;
+        }
+        else if (it->m_registry.expired())
+        {
+            it = cache.m_entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    if (state == nullptr)
+    {
+        state = m_externalThreads->Acquire();
+        cache.m_entries.push_back({m_poolId, m_externalThreads, state});
+    }
+
+    t_lastPoolId = m_poolId;
+    t_lastExternalState = state;
+    return *state;
+}
+
+bool ThreadPool::WaitForTask(ST_WorkerSlot* slot, ST_Task& task, std::chrono::steady_clock::time_point deadline)
+{
+    if (TryGetTask(slot, task))
+    {
+        return true;
+    }
+
+    if (slot == nullptr)
+    {
+        // 没有槽位的线程无法被定向唤醒，退化为短暂休眠轮询
+        while (!m_stop && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (TryGetTask(slot, task))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 自旋阶段：短暂等待新任务，避免休眠/唤醒的系统调用开销；
+    // 自旋期间拿到任务则加倍下次的自旋轮数，否则减半，范围由调度配置档决定，配置档不自旋时直接休眠
+    const ST_ProfileParams& profile = ProfileParams(m_profile.load(std::memory_order_relaxed));
+    if (profile.m_maxSpinRounds > 0)
+    {
+        slot->m_spinLimit = (std::clamp)(slot->m_spinLimit, profile.m_minSpinRounds, profile.m_maxSpinRounds);
+
+        bool found = false;
+        m_spinningCount.fetch_add(1);
+        for (size_t round = 0; round < slot->m_spinLimit && !m_stop; ++round)
+        {
+            for (size_t i = 0; i < PAUSES_PER_ROUND; ++i)
+            {
+                CpuRelax();
+            }
+
+            if (TryGetTask(slot, task))
+            {
+                found = true;
+                break;
+            }
+        }
+        m_spinningCount.fetch_sub(1);
+
+        if (found)
+        {
+            slot->m_spinLimit = (std::min)(slot->m_spinLimit * 2, profile.m_maxSpinRounds);
+            return true;
+        }
+        slot->m_spinLimit = (std::max)(slot->m_spinLimit / 2, profile.m_minSpinRounds);
+    }
+
+    // 休眠阶段：先登记到休眠列表再重新检查队列，提交者入队后检查休眠列表，保证不会丢失唤醒
+    while (!m_stop)
+    {
+        {
+            std::lock_guard<std::mutex> lock(slot->m_parkMutex);
+            slot->m_wakeSignal = false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_parkMutex);
+            m_parkedWorkers.push_back(slot);
+            m_parkedCount.fetch_add(1);
+        }
+        slot->m_stats.load(std::memory_order_relaxed)->m_parks.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_stop || TryGetTask(slot, task))
+        {
+            CancelPark(slot);
+            return !m_stop;
+        }
+
+        bool signaled = false;
+        {
+            std::unique_lock<std::mutex> lock(slot->m_parkMutex);
+            signaled = slot->m_parkCondition.wait_until(lock, deadline, [slot]() { return slot->m_wakeSignal; });
+        }
+
+        if (!signaled)
+        {
+            CancelPark(slot);
+            return TryGetTask(slot, task);
+        }
+
+        if (TryGetTask(slot, task))
+        {
+            return true;
+        }
+
+        // 阻塞结束后线程数超出目标，被唤醒的空闲线程返回并退出
+        if (m_totalThreads.load(std::memory_order_relaxed) > EffectiveTargetThreads())
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::CancelPark(ST_WorkerSlot* slot)
+{
+    std::lock_guard<std::mutex> lock(m_parkMutex);
+    auto it = std::find(m_parkedWorkers.begin(), m_parkedWorkers.end(), slot);
+    if (it != m_parkedWorkers.end())
+    {
+        m_parkedWorkers.erase(it);
+        m_parkedCount.fetch_sub(1);
+    }
+}
+
+void ThreadPool::WakeOneWorker(bool ignoreSpinning, size_t preferredNode)
+{
+    // 与工作线程登记休眠后的重新检查配对，保证入队对其可见
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((!ignoreSpinning && m_spinningCount.load(std::memory_order_relaxed) > 0) || m_parkedCount.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    ST_WorkerSlot* slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_parkMutex);
+        if (m_parkedWorkers.empty())
+        {
+            return;
+        }
+        // 后进先出，优先唤醒缓存仍然较热的线程，让长期空闲的线程自然超时退出；指定分区时优先唤醒该分区的线程
+        auto it = m_parkedWorkers.end() - 1;
+        if (preferredNode != SIZE_MAX)
+        {
+            auto preferred = std::find_if(m_parkedWorkers.rbegin(), m_parkedWorkers.rend(),
+                [preferredNode](const ST_WorkerSlot* parked) { return parked->m_node == preferredNode; });
+            if (preferred != m_parkedWorkers.rend())
+            {
+                it = std::next(preferred).base();
+            }
+        }
+        slot = *it;
+        m_parkedWorkers.erase(it);
+        m_parkedCount.fetch_sub(1);
+    }
+
+    SignalWorker(slot);
+}
+
+void ThreadPool::WakeForSubmit(size_t preferredNode)
+{
+    size_t wakeBatch = ProfileParams(m_profile.load(std::memory_order_relaxed)).m_wakeBatch;
+    if (wakeBatch > 1)
+    {
+        // 只有自旋中的线程保证会立即取走新任务（正在执行长任务的线程不算），此时积压到一批再额外唤醒一个休眠线程，被唤醒的线程一次取走一批。
+        // 与工作线程结束自旋登记休眠后的重新检查配对：读到的自旋数包含该线程时，它的重新检查能看到新任务
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_spinningCount.load(std::memory_order_relaxed) > 0)
+        {
+            if (m_submitsSinceWake.fetch_add(1, std::memory_order_relaxed) + 1 < wakeBatch)
+            {
+                return;
+            }
+            m_submitsSinceWake.store(0, std::memory_order_relaxed);
+            WakeOneWorker(true, preferredNode);
+            return;
+        }
+    }
+    WakeOneWorker(false, preferredNode);
+}
+
+void ThreadPool::WakeForBulkSubmit(size_t taskCount, bool ignoreSpinning, size_t preferredNode)
+{
+    // 与工作线程登记休眠后的重新检查配对，保证入队对其可见
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    size_t wakeBatch = ProfileParams(m_profile.load(std::memory_order_relaxed)).m_wakeBatch;
+    size_t needed = (taskCount + wakeBatch - 1) / wakeBatch;
+    size_t spinning = ignoreSpinning ? 0 : m_spinningCount.load(std::memory_order_relaxed);
+    if (needed <= spinning)
+    {
+        return;
+    }
+
+    size_t wakeCount = (std::min)(needed - spinning, m_parkedCount.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < wakeCount; ++i)
+    {
+        WakeOneWorker(true, preferredNode);
+    }
+}
+
+ST_WorkerSlot* ThreadPool::CurrentHelpingSlot() const
+{
+    return (t_currentPool == this && !m_stop) ? t_currentSlot : nullptr;
+}
+
+bool ThreadPool::BeginHelpingPark(ST_WorkerSlot* slot, ST_Task& task)
+{
+    // 与WaitForTask的休眠阶段相同：先登记到休眠列表再重新检查队列，提交者入队后检查休眠列表，保证不会丢失唤醒
+    {
+        std::lock_guard<std::mutex> lock(slot->m_parkMutex);
+        slot->m_wakeSignal = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_parkMutex);
+        m_parkedWorkers.push_back(slot);
+        m_parkedCount.fetch_add(1);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_stop || TryGetTask(slot, task))
+    {
+        CancelPark(slot);
+        return false;
+    }
+    return true;
+}
+
+void ThreadPool::EndHelpingPark(ST_WorkerSlot* slot, bool sleep)
+{
+    if (sleep)
+    {
+        slot->m_stats.load(std::memory_order_relaxed)->m_parks.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(slot->m_parkMutex);
+        slot->m_parkCondition.wait(lock, [slot]() { return slot->m_wakeSignal; });
+    }
+    CancelPark(slot);
+}
+
+void ThreadPool::WakeWorker(ST_WorkerSlot* slot)
+{
+    // 与工作线程登记休眠后的重新检查配对，保证收件箱中的任务对其可见
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_parkedCount.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_parkMutex);
+        auto it = std::find(m_parkedWorkers.begin(), m_parkedWorkers.end(), slot);
+        if (it == m_parkedWorkers.end())
+        {
+            // 未休眠的线程在下次取任务时会检查收件箱
+            return;
+        }
+        m_parkedWorkers.erase(it);
+        m_parkedCount.fetch_sub(1);
+    }
+
+    SignalWorker(slot);
+}
+
+void ThreadPool::SignalWorker(ST_WorkerSlot* slot)
+{
+    {
+        std::lock_guard<std::mutex> lock(slot->m_parkMutex);
+        slot->m_wakeSignal = true;
+    }
+    slot->m_parkCondition.notify_one();
+    slot->m_stats.load(std::memory_order_relaxed)->m_wakeups.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ThreadPool::WakeAllWorkers()
+{
+    std::vector<ST_WorkerSlot*> parkedWorkers;
+    {
+        std::lock_guard<std::mutex> lock(m_parkMutex);
+        parkedWorkers.swap(m_parkedWorkers);
+        m_parkedCount.store(0);
+    }
+
+    for (ST_WorkerSlot* slot : parkedWorkers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(slot->m_parkMutex);
+            slot->m_wakeSignal = true;
+        }
+        slot->m_parkCondition.notify_one();
+    }
+}
+
+bool ThreadPool::TryGetTask(ST_WorkerSlot* slot, ST_Task& task)
+{
+    // 定向任务只能由本线程执行，先于共享队列检查
+    if (slot != nullptr)
+    {
+        PriorityTaskQueue* inbox = slot->m_inbox.load(std::memory_order_acquire);
+        if (inbox != nullptr && !inbox->empty() && inbox->try_pop(task))
+        {
+            return true;
+        }
+    }
+
+    if (slot != nullptr && slot->m_localTasks.Size() > 0)
+    {
+        // 本地队列只保存普通及以下优先级任务，先检查全局的高优先级通道
+        if (m_tasks.try_pop_lane(EM_TaskPriority::Critical, task) || m_tasks.try_pop_lane(EM_TaskPriority::High, task))
+        {
+            return true;
+        }
+
+        if (ST_Task* localTask = slot->m_localTasks.Pop())
+        {
+            task = std::move(*localTask);
+            DestroyPooledTask(localTask);
+            return true;
+        }
+    }
+
+    size_t node = SIZE_MAX;
+    if (!m_nodeQueues.empty())
+    {
+        node = slot != nullptr ? slot->m_node : CurrentNode();
+        if (node < m_nodeQueues.size() && !m_nodeQueues[node]->empty())
+        {
+            // 分区队列同样只保存普通及以下优先级任务
+            if (m_tasks.try_pop_lane(EM_TaskPriority::Critical, task) || m_tasks.try_pop_lane(EM_TaskPriority::High, task)
+                || m_nodeQueues[node]->try_pop(task))
+            {
+                return true;
+            }
+        }
+    }
+
+    if (m_tasks.try_pop(task))
+    {
+        PrefetchBatch(slot, m_tasks);
+        return true;
+    }
+    if (TryPopSubmitShard(slot, task))
+    {
+        return true;
+    }
+
+    // 批量预取的任务放在本地队列中，全局队列模式下同样需要窃取，避免被困在忙碌线程的本地队列里
+    bool stealing = m_config.m_schedulerMode == EM_SchedulerMode::WorkStealing
+        || ProfileParams(m_profile.load(std::memory_order_relaxed)).m_popBatch > 1;
+    if (m_nodeQueues.empty())
+    {
+        return (stealing && TrySteal(slot, task)) || TryPopOrphanedInbox(task);
+    }
+
+    // 跨NUMA节点迁移任务的代价最高，放在分区内窃取之后
+    if (stealing && node < m_nodeQueues.size() && TrySteal(slot, task, node))
+    {
+        return true;
+    }
+    if (TryPopRemoteNode(node, task))
+    {
+        return true;
+    }
+    return (stealing && TrySteal(slot, task)) || TryPopOrphanedInbox(task);
+}
+
+bool ThreadPool::TryPopRemoteNode(size_t node, ST_Task& task)
+{
+    size_t nodeCount = m_nodeQueues.size();
+    size_t start = node < nodeCount ? node + 1 : 0;
+    for (size_t i = 0; i < nodeCount; ++i)
+    {
+        size_t index = (start + i) % nodeCount;
+        if (index != node && m_nodeQueues[index]->try_pop(task))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+PriorityTaskQueue& ThreadPool::WorkerInbox(ST_WorkerSlot& slot)
+{
+    PriorityTaskQueue* inbox = slot.m_inbox.load(std::memory_order_acquire);
+    if (inbox != nullptr)
+    {
+        return *inbox;
+    }
+
+    // 多个提交者同时创建时只保留第一个
+    auto created = std::make_unique<PriorityTaskQueue>(m_tasks.max_size(), SUBMIT_SHARD_LANE_CAPACITY);
+    created->configure(m_config.m_priorityPolicy, std::chrono::milliseconds(m_config.m_agingThreshold));
+    if (slot.m_inbox.compare_exchange_strong(inbox, created.get(), std::memory_order_acq_rel))
+    {
+        return *created.release();
+    }
+    return *inbox;
+}
+
+bool ThreadPool::TryPopOrphanedInbox(ST_Task& task)
+{
+    size_t slotCount = m_workerSlotHighWater.load(std::memory_order_acquire);
+    for (size_t i = 0; i < slotCount; ++i)
+    {
+        PriorityTaskQueue* inbox = m_workerSlots[i].m_inbox.load(std::memory_order_acquire);
+        if (inbox != nullptr && !m_workerSlots[i].m_inUse.load() && !inbox->empty() && inbox->try_pop(task))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ThreadPool::AffinityWorkerIndex(size_t hash) const
+{
+    uint64_t mixed = static_cast<uint64_t>(hash);
+    mixed ^= mixed >> 33;
+    mixed *= 0xff51afd7ed558ccdULL;
+    mixed ^= mixed >> 33;
+    return static_cast<size_t>(mixed % m_residentWorkers.load(std::memory_order_relaxed));
+}
+
+size_t ThreadPool::GetCurrentWorkerIndex() const
+{
+    if (t_currentPool == this && t_currentSlot != nullptr)
+    {
+        return static_cast<size_t>(t_currentSlot - m_workerSlots.get());
+    }
+    return SIZE_MAX;
+}
+
+bool ThreadPool::TryPopSubmitShard(ST_WorkerSlot* slot, ST_Task& task)
+{
+    size_t shardCount = m_submitShards.size();
+    if (shardCount == 0)
+    {
+        return false;
+    }
+
+    // 每次调用轮转起点，各工作线程均匀地消化所有分片
+    size_t start = t_submitShardCursor++;
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        PriorityTaskQueue& shard = *m_submitShards[(start + i) % shardCount];
+        if (!shard.empty() && shard.try_pop(task))
+        {
+            PrefetchBatch(slot, shard);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::PrefetchBatch(ST_WorkerSlot* slot, PriorityTaskQueue& queue)
+{
+    size_t popBatch = ProfileParams(m_profile.load(std::memory_order_relaxed)).m_popBatch;
+    if (slot == nullptr || popBatch <= 1 || t_currentSlot != slot)
+    {
+        return;
+    }
+
+    // 本地队列只保存普通及以下优先级任务，高优先级任务留在共享队列中；每条通道只做一次批量出队
+    std::array<ST_Task, MAX_POP_BATCH - 1> extra;
+    std::span<ST_Task> buffer(extra.data(), (std::min)(popBatch, MAX_POP_BATCH) - 1);
+    size_t count = queue.try_pop_lane_bulk(EM_TaskPriority::Normal, buffer);
+    if (count < buffer.size())
+    {
+        count += queue.try_pop_lane_bulk(EM_TaskPriority::Low, buffer.subspan(count));
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        slot->m_localTasks.Push(CreatePooledTask(std::move(buffer[i])));
+    }
+}
+
+bool ThreadPool::HasQueuedTasks() const
+{
+    if (!m_tasks.empty())
+    {
+        return true;
+    }
+    for (const auto& shard : m_submitShards)
+    {
+        if (!shard->empty())
+        {
+            return true;
+        }
+    }
+    for (const auto& nodeQueue : m_nodeQueues)
+    {
+        if (!nodeQueue->empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::TryPeekOldestTicks(int64_t& ticks) const
+{
+    bool found = m_tasks.try_peek_oldest_ticks(ticks);
+    for (const auto& shard : m_submitShards)
+    {
+        int64_t shardTicks = 0;
+        if (shard->try_peek_oldest_ticks(shardTicks) && (!found || shardTicks < ticks))
+        {
+            ticks = shardTicks;
+            found = true;
+        }
+    }
+    for (const auto& nodeQueue : m_nodeQueues)
+    {
+        int64_t nodeTicks = 0;
+        if (nodeQueue->try_peek_oldest_ticks(nodeTicks) && (!found || nodeTicks < ticks))
+        {
+            ticks = nodeTicks;
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool ThreadPool::RunPendingTask()
+{
+    ST_WorkerSlot* slot = (t_currentPool == this) ? t_currentSlot : nullptr;
+    ST_Task task;
+    if (!TryGetTask(slot, task))
+    {
+        return false;
+    }
+
+    ExecuteTask(task);
+    return true;
+}
+
+void ThreadPool::ExecuteTask(ST_Task& task)
+{
+    // 记录排队等待时间与执行时间，写入当前线程自己的统计实例
+    ST_ThreadStats::ST_PriorityCounters& counters = CurrentStats().Priority(task.m_priority);
+    auto startTime = std::chrono::steady_clock::now();
+    if (task.IsCancelled(startTime))
+    {
+        // 已取消或超过截止时间的任务不执行，销毁任务函数时其future以TaskCancelledException完成
+        counters.m_cancelled.fetch_add(1, std::memory_order_relaxed);
+        task.m_func = nullptr;
+        FinishTasks(1);
+        return;
+    }
+    counters.m_queueWait.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(startTime - task.m_submitTime).count()));
+
+    try
+    {
+        ++m_activeThreads;
+        task.m_func();
+    }
+    catch (...) {}
+    --m_activeThreads;
+
+    auto endTime = std::chrono::steady_clock::now();
+    counters.m_runTime.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count()));
+    counters.m_completed.fetch_add(1, std::memory_order_relaxed);
+    if (m_tracing.load(std::memory_order_relaxed))
+    {
+        RecordTrace(task, startTime, endTime);
+    }
+
+    // 先销毁任务对象再递减计数，等待者返回时任务捕获的资源已经释放
+    task.m_func = nullptr;
+    FinishTasks(1);
+}
+
+bool ThreadPool::TrySteal(ST_WorkerSlot* self, ST_Task& task, size_t node)
+{
+    size_t slotCount = m_workerSlotHighWater.load(std::memory_order_acquire);
+    if (slotCount == 0)
+    {
+        return false;
+    }
+
+    size_t start = NextStealRandom() % slotCount;
+    for (size_t i = 0; i < slotCount; ++i)
+    {
+        ST_WorkerSlot* victim = &m_workerSlots[(start + i) % slotCount];
+        if (victim == self || (node != SIZE_MAX && victim->m_node != node))
+        {
+            continue;
+        }
+
+        if (ST_Task* stolenTask = victim->m_localTasks.Steal())
+        {
+            task = std::move(*stolenTask);
+            DestroyPooledTask(stolenTask);
+            CurrentStats().m_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ThreadPool::GetPendingTaskCount() const
+{
+    size_t count = m_tasks.size();
+    for (const auto& shard : m_submitShards)
+    {
+        count += shard->size();
+    }
+    for (const auto& nodeQueue : m_nodeQueues)
+    {
+        count += nodeQueue->size();
+    }
+    size_t slotCount = m_workerSlotHighWater.load(std::memory_order_acquire);
+    for (size_t i = 0; i < slotCount; ++i)
+    {
+        count += m_workerSlots[i].m_localTasks.Size();
+        if (const PriorityTaskQueue* inbox = m_workerSlots[i].m_inbox.load(std::memory_order_acquire))
+        {
+            count += inbox->size();
+        }
+    }
+    return count;
+}
+
+ST_WorkerSlot* ThreadPool::AcquireWorkerSlot()
+{
+    for (size_t i = 0; i < MAX_WORKER_SLOTS; ++i)
+    {
+        bool expected = false;
+        if (m_workerSlots[i].m_inUse.compare_exchange_strong(expected, true))
+        {
+            // 统计实例先于槽位范围发布，GetStats遍历到的槽位要么没有统计，要么统计已完整构造
+            if (m_workerSlots[i].m_stats.load(std::memory_order_relaxed) == nullptr)
+            {
+                m_workerSlots[i].m_stats.store(new ST_ThreadStats(), std::memory_order_release);
+            }
+            size_t highWater = m_workerSlotHighWater.load();
+            while (highWater < i + 1 && !m_workerSlotHighWater.compare_exchange_weak(highWater, i + 1)) {}
+            return &m_workerSlots[i];
+        }
+    }
+    return nullptr;
+}
+
+void ThreadPool::ReleaseWorkerSlot(ST_WorkerSlot* slot)
+{
+    if (slot == nullptr)
+    {
+        return;
+    }
+
+    while (ST_Task* localTask = slot->m_localTasks.Pop())
+    {
+        // 停止时直接丢弃，否则转移到全局队列；全局队列已满时就地执行，保证任务不丢失
+        if (m_stop)
+        {
+            DestroyPooledTask(localTask);
+            FinishTasks(1);
+        }
+        else if (!m_tasks.try_push(std::move(*localTask)))
+        {
+            ExecuteTask(*localTask);
+            DestroyPooledTask(localTask);
+        }
+        else
+        {
+            DestroyPooledTask(localTask);
+        }
+    }
+    slot->m_inUse.store(false);
+
+    // 收件箱在释放槽位之后清空：之后推入的提交者会看到槽位空闲并唤醒其他线程接管
+    PriorityTaskQueue* inbox = slot->m_inbox.load(std::memory_order_acquire);
+    if (inbox == nullptr)
+    {
+        return;
+    }
+    bool moved = false;
+    ST_Task inboxTask;
+    while (inbox->try_pop(inboxTask))
+    {
+        if (m_stop)
+        {
+            inboxTask.m_func = nullptr;
+            FinishTasks(1);
+        }
+        else if (!m_tasks.try_push(std::move(inboxTask)))
+        {
+            ExecuteTask(inboxTask);
+        }
+        else
+        {
+            moved = true;
+        }
+    }
+    if (moved)
+    {
+        WakeOneWorker(true);
+    }
+}
+
+void ThreadPool::WorkerThread()
+{
+    ST_WorkerSlot* slot = AcquireWorkerSlot();
+    t_currentPool = this;
+    t_currentSlot = slot;
+    ApplyWorkerPlacement(slot);
+
+    while (true)
+    {
+        ST_Task task;
+        bool hasTask = false;
+
+        // 自旋后休眠等待任务，超过空闲保持时间则返回
+        {
+            std::shared_lock<std::shared_mutex> configLock(m_configMutex);
+            auto timeout = std::chrono::milliseconds(m_config.m_keepAliveTime);
+            configLock.unlock();
+
+            hasTask = WaitForTask(slot, task, std::chrono::steady_clock::now() + timeout);
+        }
+
+        // 检查停止信号
+        if (m_stop)
+        {
+            ReleaseWorkerSlot(slot);
+            --m_totalThreads;
+            return;
+        }
+
+        // 检查空闲超时
+        if (!hasTask)
+        {
+            std::shared_lock<std::shared_mutex> configLock(m_configMutex);
+            size_t minThreads = m_config.m_minThreads;
+            configLock.unlock();
+
+            // 常驻槽位的线程不因空闲退出，SubmitNear映射到的线程保持存在；阻塞中的线程不算在下限内，避免可运行线程数低于下限
+            if ((slot == nullptr || static_cast<size_t>(slot - m_workerSlots.get()) >= minThreads)
+                && TryRetireWorker(minThreads + (EffectiveTargetThreads() - m_targetThreads.load(std::memory_order_relaxed))))
+            {
+                ReleaseWorkerSlot(slot);
+                MarkWorkerExited();
+                return;
+            }
+            continue;
+        }
+
+        // 队列中仍有任务时继续唤醒下一个线程，形成链式唤醒
+        if (HasQueuedTasks())
+        {
+            WakeOneWorker();
+        }
+
+        // 执行任务
+        ExecuteTask(task);
+
+        // 控制器降低目标线程数或阻塞结束后，多出的线程在任务之间退出
+        size_t effectiveTarget = EffectiveTargetThreads();
+        if (m_totalThreads.load(std::memory_order_relaxed) > effectiveTarget && !m_stop && TryRetireWorker(effectiveTarget))
+        {
+            ReleaseWorkerSlot(slot);
+            MarkWorkerExited();
+            return;
+        }
+    }
+}
+
+void ThreadPool::ConfigurePlacement()
+{
+    const std::vector<int>& cpuSet = m_config.m_cpuSet;
+    if (cpuSet.empty() && !m_config.m_numaAware)
+    {
+        return;
+    }
+
+    std::vector<std::vector<int>> nodes;
+    if (m_config.m_numaAware)
+    {
+        // 各节点与配置的CPU集合取交集，丢弃交集为空的节点
+        for (std::vector<int>& cpus : DetectNumaNodes())
+        {
+            if (!cpuSet.empty())
+            {
+                cpus.erase(std::remove_if(cpus.begin(), cpus.end(), [&cpuSet](int cpu)
+                {
+                    return std::find(cpuSet.begin(), cpuSet.end(), cpu) == cpuSet.end();
+                }), cpus.end());
+            }
+            if (!cpus.empty())
+            {
+                nodes.push_back(std::move(cpus));
+            }
+        }
+    }
+    if (nodes.empty())
+    {
+        nodes.push_back(cpuSet);
+    }
+
+    int maxCpu = -1;
+    for (const std::vector<int>& cpus : nodes)
+    {
+        for (int cpu : cpus)
+        {
+            maxCpu = (std::max)(maxCpu, cpu);
+        }
+    }
+    m_cpuToNode.assign(static_cast<size_t>(maxCpu + 1), -1);
+    for (size_t node = 0; node < nodes.size(); ++node)
+    {
+        for (int cpu : nodes[node])
+        {
+            if (cpu >= 0)
+            {
+                m_cpuToNode[static_cast<size_t>(cpu)] = static_cast<int>(node);
+            }
+        }
+    }
+
+    // 槽位按下标轮流分配到各分区，槽位复用时分区不变，窃取时可以无锁读取
+    for (size_t i = 0; i < MAX_WORKER_SLOTS; ++i)
+    {
+        m_workerSlots[i].m_node = i % nodes.size();
+    }
+
+    if (m_config.m_numaAware && nodes.size() > 1)
+    {
+        // 上限由构造函数随后统一划分
+        for (size_t node = 0; node < nodes.size(); ++node)
+        {
+            auto nodeQueue = std::make_unique<PriorityTaskQueue>();
+            nodeQueue->configure(m_config.m_priorityPolicy, std::chrono::milliseconds(m_config.m_agingThreshold));
+            m_nodeQueues.push_back(std::move(nodeQueue));
+        }
+    }
+    m_nodeCpus = std::move(nodes);
+}
+
+void ThreadPool::ApplyWorkerPlacement(ST_WorkerSlot* slot)
+{
+    size_t index = slot != nullptr ? static_cast<size_t>(slot - m_workerSlots.get()) : MAX_WORKER_SLOTS;
+    if (!m_nodeCpus.empty())
+    {
+        size_t node = slot != nullptr ? slot->m_node : 0;
+        PinCurrentThreadToCpus(m_nodeCpus[node]);
+    }
+
+    if (!m_config.m_threadNamePrefix.empty())
+    {
+        SetCurrentThreadName(m_config.m_threadNamePrefix + "-" + std::to_string(index));
+    }
+}
+
+size_t ThreadPool::CurrentNode() const
+{
+    if (t_currentPool == this && t_currentSlot != nullptr)
+    {
+        return t_currentSlot->m_node;
+    }
+
+    int cpu = CurrentCpu();
+    if (cpu >= 0 && static_cast<size_t>(cpu) < m_cpuToNode.size() && m_cpuToNode[static_cast<size_t>(cpu)] >= 0)
+    {
+        return static_cast<size_t>(m_cpuToNode[static_cast<size_t>(cpu)]);
+    }
+    return SIZE_MAX;
+}
+
+ST_ThreadPoolStats ThreadPool::GetStats() const
+{
+    // 先把各线程的直方图合并到临时直方图，再统一计算分位数
+    std::array<LatencyHistogram, PriorityTaskQueue::PRIORITY_LEVELS> queueWait;
+    std::array<LatencyHistogram, PriorityTaskQueue::PRIORITY_LEVELS> runTime;
+    LatencyHistogram totalQueueWait;
+    LatencyHistogram totalRunTime;
+
+    ST_ThreadPoolStats stats;
+    ForEachStats([&](const ST_ThreadStats& threadStats)
+    {
+        for (size_t i = 0; i < PriorityTaskQueue::PRIORITY_LEVELS; ++i)
+        {
+            const ST_ThreadStats::ST_PriorityCounters& counters = threadStats.m_priorities[i];
+            stats.m_priorities[i].m_submitted += counters.m_submitted.load(std::memory_order_relaxed);
+            stats.m_priorities[i].m_completed += counters.m_completed.load(std::memory_order_relaxed);
+            stats.m_priorities[i].m_rejected += counters.m_rejected.load(std::memory_order_relaxed);
+            stats.m_priorities[i].m_cancelled += counters.m_cancelled.load(std::memory_order_relaxed);
+            queueWait[i].Merge(counters.m_queueWait);
+            runTime[i].Merge(counters.m_runTime);
+        }
+        stats.m_steals += threadStats.m_steals.load(std::memory_order_relaxed);
+        stats.m_parks += threadStats.m_parks.load(std::memory_order_relaxed);
+        stats.m_wakeups += threadStats.m_wakeups.load(std::memory_order_relaxed);
+    });
+
+    for (size_t i = 0; i < PriorityTaskQueue::PRIORITY_LEVELS; ++i)
+    {
+        ST_PriorityStats& priorityStats = stats.m_priorities[i];
+        priorityStats.m_queueWait = SummarizeHistogram(queueWait[i]);
+        priorityStats.m_runTime = SummarizeHistogram(runTime[i]);
+        stats.m_submitted += priorityStats.m_submitted;
+        stats.m_completed += priorityStats.m_completed;
+        stats.m_rejected += priorityStats.m_rejected;
+        stats.m_cancelled += priorityStats.m_cancelled;
+        totalQueueWait.Merge(queueWait[i]);
+        totalRunTime.Merge(runTime[i]);
+    }
+    stats.m_queueWait = SummarizeHistogram(totalQueueWait);
+    stats.m_runTime = SummarizeHistogram(totalRunTime);
+    stats.m_threadCount = m_totalThreads.load();
+    stats.m_activeThreads = m_activeThreads.load();
+    stats.m_pendingTasks = GetPendingTaskCount();
+    stats.m_blockingThreads = m_blockingWorkers.load();
+    stats.m_compensations = m_compensationCount.load();
+    return stats;
+}
+
+void ThreadPool::ResetStats()
+{
+    size_t highWater = m_workerSlotHighWater.load(std::memory_order_acquire);
+    for (size_t i = 0; i < highWater; ++i)
+    {
+        if (ST_ThreadStats* stats = m_workerSlots[i].m_stats.load(std::memory_order_acquire))
+        {
+            stats->Reset();
+        }
+    }
+    m_externalThreads->ForEach([](ST_ExternalThreadState& state) { state.m_stats.Reset(); });
+    m_externalThreads->m_shared.m_stats.Reset();
+}
+
+void ThreadPool::EnableTracing(size_t eventsPerThread)
+{
+    m_traceEventsPerThread.store((std::max)(eventsPerThread, size_t(1)), std::memory_order_relaxed);
+    m_tracing.store(true, std::memory_order_relaxed);
+}
+
+void ThreadPool::DisableTracing()
+{
+    m_tracing.store(false, std::memory_order_relaxed);
+}
+
+void ThreadPool::RecordTrace(const ST_Task& task, std::chrono::steady_clock::time_point beginTime, std::chrono::steady_clock::time_point endTime)
+{
+    ST_TraceRecord record;
+    record.m_enqueueTicks = task.m_submitTime.time_since_epoch().count();
+    record.m_beginTicks = beginTime.time_since_epoch().count();
+    record.m_endTicks = endTime.time_since_epoch().count();
+    record.m_priority = static_cast<uint32_t>(task.m_priority);
+
+    // 槽位与非工作线程本地状态中的缓冲都只由拥有者线程创建和写入
+    std::atomic<TaskTraceRing*>* owner = nullptr;
+    if (t_currentPool == this && t_currentSlot != nullptr)
+    {
+        owner = &t_currentSlot->m_traceRing;
+    }
+    else
+    {
+        ST_ExternalThreadState& state = CurrentExternalState();
+        if (&state == &m_externalThreads->m_shared)
+        {
+            return;
+        }
+        owner = &state.m_traceRing;
+    }
+
+    TaskTraceRing* ring = owner->load(std::memory_order_relaxed);
+    if (ring == nullptr)
+    {
+        ring = new TaskTraceRing(m_traceEventsPerThread.load(std::memory_order_relaxed));
+        owner->store(ring, std::memory_order_release);
+    }
+    ring->Record(record);
+}
+
+void ThreadPool::WriteChromeTrace(std::ostream& out) const
+{
+    std::vector<ST_TraceTrack> tracks;
+    size_t highWater = m_workerSlotHighWater.load(std::memory_order_acquire);
+    for (size_t i = 0; i < highWater; ++i)
+    {
+        if (const TaskTraceRing* ring = m_workerSlots[i].m_traceRing.load(std::memory_order_acquire))
+        {
+            ST_TraceTrack track;
+            track.m_trackId = static_cast<uint32_t>(i);
+            track.m_name = "Worker " + std::to_string(i);
+            ring->Snapshot(track.m_records);
+            tracks.push_back(std::move(track));
+        }
+    }
+
+    m_externalThreads->ForEach([&tracks](const ST_ExternalThreadState& state)
+    {
+        if (const TaskTraceRing* ring = state.m_traceRing.load(std::memory_order_acquire))
+        {
+            ST_TraceTrack track;
+            track.m_trackId = static_cast<uint32_t>(MAX_WORKER_SLOTS + state.m_index);
+            track.m_name = "External " + std::to_string(state.m_index);
+            ring->Snapshot(track.m_records);
+            tracks.push_back(std::move(track));
+        }
+    });
+
+    ::WriteChromeTrace(out, tracks);
+}
+
+ST_PriorityWaitStats ThreadPool::GetPriorityWaitStats(EM_TaskPriority priority) const
+{
+    LatencyHistogram histogram;
+    ForEachStats([&histogram, priority](const ST_ThreadStats& threadStats)
+    {
+        histogram.Merge(threadStats.m_priorities[PriorityTaskQueue::LaneIndex(priority)].m_queueWait);
+    });
+
+    ST_LatencySummary summary = SummarizeHistogram(histogram);
+    ST_PriorityWaitStats stats;
+    stats.m_count = summary.m_count;
+    stats.m_avgWaitUs = summary.m_avgUs;
+    stats.m_p50WaitUs = summary.m_p50Us;
+    stats.m_p99WaitUs = summary.m_p99Us;
+    stats.m_p999WaitUs = summary.m_p999Us;
+    stats.m_maxWaitUs = summary.m_maxUs;
+    return stats;
+}
+
+void ThreadPool::ResetPriorityWaitStats()
+{
+    size_t highWater = m_workerSlotHighWater.load(std::memory_order_acquire);
+    for (size_t i = 0; i < highWater; ++i)
+    {
+        if (ST_ThreadStats* stats = m_workerSlots[i].m_stats.load(std::memory_order_acquire))
+        {
+            for (auto& counters : stats->m_priorities)
+            {
+                counters.m_queueWait.Reset();
+            }
+        }
+    }
+    auto resetQueueWait = [](ST_ThreadStats& stats)
+    {
+        for (auto& counters : stats.m_priorities)
+        {
+            counters.m_queueWait.Reset();
+        }
+    };
+    m_externalThreads->ForEach([&resetQueueWait](ST_ExternalThreadState& state) { resetQueueWait(state.m_stats); });
+    resetQueueWait(m_externalThreads->m_shared.m_stats);
+}
+
+void ThreadPool::AdjustThreadCount()
+{
+    std::shared_lock<std::shared_mutex> configLock(m_configMutex);
+    size_t minThreads = m_config.m_minThreads;
+    size_t maxThreads = (std::max)(m_config.m_maxThreads, minThreads); // 默认配置在单核机器上可能出现最小值大于最大值，以最小值为准
+    configLock.unlock();
+
+    size_t target = m_targetThreads.load();
+    target = (std::min)((std::max)(target, minThreads), maxThreads);
+    m_targetThreads.store(target);
+
+    while (!m_stop && m_totalThreads.load() < EffectiveTargetThreads())
+    {
+        CreateWorkerThread();
+    }
+
+    if (maxThreads > minThreads)
+    {
+        EnsureMonitorThread();
+    }
+}
+
+void ThreadPool::CreateWorkerThread()
+{
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    if (m_stop)
+    {
+        return;
+    }
+
+    ReapExitedWorkers();
+    ++m_totalThreads;
+    m_workers.emplace_back(&ThreadPool::WorkerThread, this);
+}
+
+void ThreadPool::EnsureMonitorThread()
+{
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    if (!m_stop && !m_monitorThread.joinable())
+    {
+        m_monitorThread = std::thread(&ThreadPool::MonitorThread, this);
+    }
+}
+
+void ThreadPool::MonitorThread()
+{
+    if (!m_config.m_threadNamePrefix.empty())
+    {
+        SetCurrentThreadName(m_config.m_threadNamePrefix + "-Mon");
+    }
+
+    uint64_t lastExecuted = GetExecutedTaskCount();
+    auto lastSample = std::chrono::steady_clock::now();
+    double lastThroughput = -1.0; // 小于0表示尚无可比较的采样
+    int direction = 1;
+    size_t streak = 0;
+
+    std::unique_lock<std::mutex> monitorLock(m_monitorMutex);
+    while (!m_stop)
+    {
+        m_monitorCondition.wait_for(monitorLock, CONTROL_INTERVAL, [this]() { return m_stop.load(); });
+        if (m_stop)
+        {
+            break;
+        }
+        monitorLock.unlock();
+
+        {
+            std::lock_guard<std::mutex> lock(m_workersMutex);
+            ReapExitedWorkers();
+        }
+
+        std::shared_lock<std::shared_mutex> configLock(m_configMutex);
+        size_t minThreads = m_config.m_minThreads;
+        size_t maxThreads = (std::max)(m_config.m_maxThreads, minThreads);
+        configLock.unlock();
+
+        auto now = std::chrono::steady_clock::now();
+        uint64_t executed = GetExecutedTaskCount();
+        uint64_t completed = executed >= lastExecuted ? executed - lastExecuted : executed; // ResetStats后计数从0重新开始
+        double seconds = std::chrono::duration<double>(now - lastSample).count();
+        double throughput = seconds > 0 ? static_cast<double>(completed) / seconds : 0.0;
+        lastExecuted = executed;
+        lastSample = now;
+
+        // 阻塞中的线程由补偿线程顶替，控制器只调整可运行的线程数
+        size_t pending = GetPendingTaskCount();
+        size_t compensation = EffectiveTargetThreads() - m_targetThreads.load();
+        size_t total = m_totalThreads.load();
+        size_t current = total > compensation ? total - compensation : 0;
+        size_t target = (std::min)((std::max)(m_targetThreads.load(), minThreads), maxThreads);
+
+        // 积压以最早任务的等待时间判断，瞬时入队又很快被取走的任务不触发调整
+        int64_t oldestTicks = 0;
+        bool backlogged = pending > 0
+            && (!TryPeekOldestTicks(oldestTicks)
+                || now.time_since_epoch().count() - oldestTicks > std::chrono::duration_cast<std::chrono::steady_clock::duration>(CONTROL_INTERVAL).count());
+        bool starving = backlogged && completed == 0;
+
+        if (!backlogged)
+        {
+            // 没有积压时不主动增减，空闲线程超过保持时间后自行退出
+            target = (std::min)((std::max)(current, minThreads), maxThreads);
+            lastThroughput = -1.0;
+            direction = 1;
+            streak = 0;
+        }
+        else if (starving)
+        {
+            // 工作线程可能都阻塞在任务中，吞吐量不能反映线程数的效果，直接增加一个线程
+            target = (std::min)(current + 1, maxThreads);
+            lastThroughput = -1.0;
+            direction = 1;
+            streak = 0;
+        }
+        else
+        {
+            if (lastThroughput < 0)
+            {
+                direction = 1;
+                streak = 0;
+            }
+            else
+            {
+                double change = lastThroughput > 0 ? (throughput - lastThroughput) / lastThroughput : 1.0;
+                if (change > THROUGHPUT_HYSTERESIS)
+                {
+                    ++streak;
+                }
+                else if (change < -THROUGHPUT_HYSTERESIS)
+                {
+                    direction = -direction;
+                    streak = 0;
+                }
+                else if (direction > 0 || current <= minThreads)
+                {
+                    // 增加线程没有带来提升时改为减少；已到下限时重新试探增加
+                    direction = (current <= minThreads) ? 1 : -1;
+                    streak = 0;
+                }
+                else
+                {
+                    // 减少线程没有造成下降，继续减少
+                    ++streak;
+                }
+            }
+
+            size_t step = size_t(1) << (std::min)(streak, MAX_STEP_SHIFT);
+            if (direction > 0)
+            {
+                // 线程数多于积压任务数没有意义
+                target = (std::min)({ current + step, current + pending, maxThreads });
+            }
+            else
+            {
+                target = current > minThreads + step ? current - step : minThreads;
+            }
+            lastThroughput = throughput;
+        }
+
+        m_targetThreads.store(target);
+        while (!m_stop && m_totalThreads.load() < EffectiveTargetThreads())
+        {
+            CreateWorkerThread();
+        }
+
+        monitorLock.lock();
+    }
+}
+
+size_t ThreadPool::EffectiveTargetThreads() const
+{
+    size_t compensation = (std::min)(m_blockingWorkers.load(std::memory_order_relaxed), m_config.m_maxBlockingThreads);
+    return m_targetThreads.load(std::memory_order_relaxed) + compensation;
+}
+
+void ThreadPool::BeginBlocking()
+{
+    size_t blocking = m_blockingWorkers.fetch_add(1) + 1;
+    if (blocking > m_config.m_maxBlockingThreads || m_stop)
+    {
+        return;
+    }
+
+    // 有空闲线程或没有待执行任务时不必补偿；之后才出现的积压由控制线程按同样的目标补齐
+    if (m_parkedCount.load() == 0 && m_spinningCount.load() == 0 && HasQueuedTasks()
+        && m_totalThreads.load() < EffectiveTargetThreads())
+    {
+        m_compensationCount.fetch_add(1, std::memory_order_relaxed);
+        CreateWorkerThread();
+    }
+    EnsureMonitorThread();
+}
+
+void ThreadPool::EndBlocking()
+{
+    m_blockingWorkers.fetch_sub(1);
+    if (m_totalThreads.load() > EffectiveTargetThreads())
+    {
+        WakeOneWorker(true);
+    }
+}
+
+ScopedBlocking::ScopedBlocking()
+    : m_pool(nullptr)
+{
+    if (t_blockingDepth++ == 0 && t_currentPool != nullptr)
+    {
+        m_pool = t_currentPool;
+        m_pool->BeginBlocking();
+    }
+}
+
+ScopedBlocking::~ScopedBlocking()
+{
+    --t_blockingDepth;
+    if (m_pool != nullptr)
+    {
+        m_pool->EndBlocking();
+    }
+}
+
+HelpingWaiter::HelpingWaiter(ThreadPool& pool)
+    : m_pool(pool)
+{
+}
+
+void HelpingWaiter::NotifyAll()
+{
+    if (m_waiters == 0)
+    {
+        return;
+    }
+
+    m_condition.notify_all();
+    for (ST_WorkerSlot* slot : m_parkedSlots)
+    {
+        m_pool.WakeWorker(slot);
+    }
+}
+
+uint64_t ThreadPool::GetExecutedTaskCount() const
+{
+    uint64_t total = 0;
+    size_t highWater = m_workerSlotHighWater.load();
+    for (size_t i = 0; i < highWater; ++i)
+    {
+        if (const ST_ThreadStats* stats = m_workerSlots[i].m_stats.load(std::memory_order_acquire))
+        {
+            for (const auto& counters : stats->m_priorities)
+            {
+                total += counters.m_completed.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return total;
+}
+
+bool ThreadPool::TryRetireWorker(size_t floor)
+{
+    size_t current = m_totalThreads.load();
+    while (current > floor)
+    {
+        if (m_totalThreads.compare_exchange_weak(current, current - 1))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::MarkWorkerExited()
+{
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    m_exitedWorkers.push_back(std::this_thread::get_id());
+}
+
+void ThreadPool::ReapExitedWorkers()
+{
+    for (std::thread::id id : m_exitedWorkers)
+    {
+        auto it = std::find_if(m_workers.begin(), m_workers.end(), [id](const std::thread& worker) { return worker.get_id() == id; });
+        if (it != m_workers.end())
+        {
+            // 该线程登记后不再访问线程池，很快就会结束
+            it->join();
+            *it = std::move(m_workers.back());
+            m_workers.pop_back();
+        }
+    }
+    m_exitedWorkers.clear();
+}
+
+size_t ThreadPool::CreateDedicatedThread(const std::string& name, std::function<void()> task, int cpuCore)
+{
+    auto threadInfo = std::make_shared<ST_DedicatedThreadInfo>();
+    threadInfo->m_name = name;
+    threadInfo->m_task = std::move(task);
+    threadInfo->m_cpuCore = cpuCore;
+
+    // 线程对象在发布到集合之前创建，其他线程读取m_thread时无需额外同步
+    threadInfo->m_thread = std::thread(&ThreadPool::DedicatedThreadWorker, this, threadInfo);
+
+    size_t threadId = m_nextThreadId++;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_dedicatedThreadsMutex);
+        m_dedicatedThreads[threadId] = threadInfo;
+    }
     return threadId;
 }
 
@@ -252,7 +2360,7 @@ bool ThreadPool::StopDedicatedThread(size_t threadId)
 {
     std::shared_ptr<ST_DedicatedThreadInfo> threadInfo;
     {
-        std::lock_guard<std::mutex> lock(m_dedicatedThreadsMutex);
+        std::shared_lock<std::shared_mutex> lock(m_dedicatedThreadsMutex);
         auto it = m_dedicatedThreads.find(threadId);
         if (it == m_dedicatedThreads.end())
         {
@@ -261,24 +2369,33 @@ bool ThreadPool::StopDedicatedThread(size_t threadId)
         threadInfo = it->second;
     }
 
+    JoinDedicatedThread(*threadInfo);
+    return true;
+}
+
+void ThreadPool::JoinDedicatedThread(ST_DedicatedThreadInfo& info)
+{
+    std::thread thread;
     {
-        std::lock_guard<std::mutex> lock(threadInfo->m_mutex);
-        threadInfo->m_stop = true;
+        std::lock_guard<std::mutex> lock(info.m_mutex);
+        info.m_stop.store(true, std::memory_order_seq_cst);
+        if (info.m_thread.joinable() && info.m_thread.get_id() != std::this_thread::get_id())
+        {
+            // 取出线程对象，并发的停止请求只有一个负责等待
+            thread = std::move(info.m_thread);
+        }
     }
-    threadInfo->m_condition.notify_all();
+    info.m_condition.notify_all();
 
-    if (threadInfo->m_thread.joinable())
+    if (thread.joinable())
     {
-        threadInfo->m_thread.join();
+        thread.join();
     }
-
-    threadInfo->m_state = EM_DedicatedThreadState::Stopped;
-    return true;
 }
 
 EM_DedicatedThreadState ThreadPool::GetDedicatedThreadState(size_t threadId) const
 {
-    std::lock_guard<std::mutex> lock(m_dedicatedThreadsMutex);
+    std::shared_lock<std::shared_mutex> lock(m_dedicatedThreadsMutex);
     auto it = m_dedicatedThreads.find(threadId);
     if (it == m_dedicatedThreads.end())
     {
@@ -287,26 +2404,142 @@ EM_DedicatedThreadState ThreadPool::GetDedicatedThreadState(size_t threadId) con
     return it->second->m_state;
 }
 
-std::vector<std::pair<size_t, ST_DedicatedThreadInfo>> ThreadPool::GetAllDedicatedThreads() const
+std::vector<ST_DedicatedThreadStatus> ThreadPool::GetAllDedicatedThreads() const
 {
-    std::vector<std::pair<size_t, ST_DedicatedThreadInfo>> result;
-    std::lock_guard<std::mutex> lock(m_dedicatedThreadsMutex);
+    std::vector<ST_DedicatedThreadStatus> result;
+    std::shared_lock<std::shared_mutex> lock(m_dedicatedThreadsMutex);
+    result.reserve(m_dedicatedThreads.size());
     for (const auto& pair : m_dedicatedThreads)
     {
-        result.emplace_back(pair.first, std::move(*pair.second));
+        const ST_DedicatedThreadInfo& info = *pair.second;
+        ST_DedicatedThreadStatus status;
+        status.m_threadId = pair.first;
+        status.m_name = info.m_name;
+        status.m_state = info.m_state.load();
+        status.m_cpuCore = info.m_cpuCore;
+        status.m_pendingCount = info.m_pending.load(std::memory_order_relaxed);
+        status.m_executedCount = info.m_executedCount.load(std::memory_order_relaxed);
+        result.push_back(std::move(status));
     }
+
+    std::sort(result.begin(), result.end(), [](const ST_DedicatedThreadStatus& a, const ST_DedicatedThreadStatus& b)
+    {
+        return a.m_threadId < b.m_threadId;
+    });
     return result;
 }
 
+bool ThreadPool::EnqueueDedicatedTask(size_t threadId, TaskFunction&& func)
+{
+    ST_DedicatedThreadInfo* info = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_dedicatedThreadsMutex);
+        auto it = m_dedicatedThreads.find(threadId);
+        if (it == m_dedicatedThreads.end())
+        {
+            return false;
+        }
+        info = it->second.get();
+    }
+
+    // 与停止并发的投递可能不会被执行，其future在线程池析构时以TaskCancelledException完成
+    if (info->m_stop.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    info->m_mailbox.push(std::move(func));
+    info->m_pending.fetch_add(1, std::memory_order_seq_cst);
+
+    // 与事件循环的"先置m_waiting再检查m_pending"配对：两者至少有一方看到对方的写入，不会丢失唤醒
+    if (info->m_waiting.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock(info->m_mutex);
+        info->m_condition.notify_one();
+    }
+    return true;
+}
+
+bool ThreadPool::WaitForDedicatedTask(ST_DedicatedThreadInfo& info, size_t spinCount)
+{
+    for (size_t i = 0; i < spinCount; ++i)
+    {
+        if (info.m_pending.load(std::memory_order_acquire) != 0)
+        {
+            return true;
+        }
+        if (info.m_stop.load(std::memory_order_acquire))
+        {
+            break;
+        }
+        CpuRelax();
+    }
+
+    std::unique_lock<std::mutex> lock(info.m_mutex);
+    info.m_waiting.store(true, std::memory_order_seq_cst);
+    info.m_condition.wait(lock, [&info]()
+    {
+        return info.m_pending.load(std::memory_order_seq_cst) != 0 || info.m_stop.load(std::memory_order_relaxed);
+    });
+    info.m_waiting.store(false, std::memory_order_relaxed);
+    return info.m_pending.load(std::memory_order_acquire) != 0;
+}
+
 void ThreadPool::DedicatedThreadWorker(std::shared_ptr<ST_DedicatedThreadInfo> threadInfo)
 {
+    ST_DedicatedThreadInfo& info = *threadInfo;
+    SetCurrentThreadName(info.m_name);
+    if (info.m_cpuCore >= 0)
+    {
+        PinCurrentThreadToCpus({ info.m_cpuCore });
+    }
+
     try
     {
-        threadInfo->m_task();  // 执行一次任务后结束
-        threadInfo->m_state = EM_DedicatedThreadState::Stopped;
+        if (info.m_task)
+        {
+            info.m_task();
+        }
+
+        while (true)
+        {
+            size_t available = info.m_pending.load(std::memory_order_acquire);
+            if (available == 0)
+            {
+                if (!WaitForDedicatedTask(info, ProfileParams(m_profile.load(std::memory_order_relaxed)).m_dedicatedSpins))
+                {
+                    break;
+                }
+                continue;
+            }
+
+            size_t batch = (std::min)(available, DEDICATED_DRAIN_BATCH);
+            for (size_t i = 0; i < batch; ++i)
+            {
+                TaskFunction func;
+                while (!info.m_mailbox.try_pop(func))
+                {
+                    // 计数已包含该任务但生产者尚未完成链接，等待其完成
+                    CpuRelax();
+                }
+
+                try
+                {
+                    func();
+                }
+                catch (...) {}
+            }
+
+            info.m_executedCount.fetch_add(batch, std::memory_order_relaxed);
+            info.m_pending.fetch_sub(batch, std::memory_order_acq_rel);
+        }
+        info.m_stop.store(true, std::memory_order_release);
+        info.m_state = EM_DedicatedThreadState::Stopped;
     }
     catch (...)
     {
-        threadInfo->m_state = EM_DedicatedThreadState::Error;
+        // 先拒绝新的投递再发布状态，看到线程已退出的调用者不会再投递成功
+        info.m_stop.store(true, std::memory_order_release);
+        info.m_state = EM_DedicatedThreadState::Error;
     }
 }
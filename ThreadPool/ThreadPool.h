@@ -11,12 +11,26 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <string>
 #include <atomic>
 #include <type_traits>
 #include "../SDKCommonDefine/SDK_Export.h"
+#include "TaskFunction.h"
+#include "Cancellation.h"
+#include "TaskTrace.h"
 #include <shared_mutex>
 #include <array>
+#include <cstdint>
 #include <unordered_map>
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <span>
+#include <utility>
+
+template <typename T>
+class TaskFuture;
 
 /// <summary>
 /// 线程池任务优先级枚举
@@ -29,6 +43,59 @@ enum class EM_TaskPriority
     Critical    ///< 关键优先级
 };
 
+/// <summary>
+/// 线程池调度模式枚举
+/// </summary>
+enum class EM_SchedulerMode
+{
+    GlobalQueue,    ///< 所有工作线程共享全局队列
+    WorkStealing    ///< 每个工作线程拥有本地双端队列，空闲时从其他线程窃取任务
+};
+
+/// <summary>
+/// 多优先级通道出队策略枚举
+/// </summary>
+enum class EM_PriorityPolicy
+{
+    Strict,     ///< 严格优先级，高优先级通道为空时才处理低优先级
+    Weighted    ///< 加权轮转，按8:4:2:1比例在Critical/High/Normal/Low之间分配出队机会
+};
+
+/// <summary>
+/// 队列已满时的过载策略枚举
+/// </summary>
+enum class EM_OverloadPolicy
+{
+    Throw,              ///< Submit/Post抛出std::runtime_error（默认）
+    Block,              ///< 阻塞等待队列空位，超过m_overloadTimeout仍无空位时按失败处理；等待期间协助执行队列中的任务
+    CallerRuns,         ///< 在提交线程上直接执行任务
+    DropOldestLowest,   ///< 丢弃优先级不高于新任务的最低优先级通道中最早的任务，无可丢弃任务时丢弃新任务
+    Reject              ///< 丢弃新任务，不抛出异常（Submit返回的future报告TaskCancelledException）
+};
+
+/// <summary>
+/// 调度配置档枚举，决定空闲工作线程的自旋预算、休眠方式、唤醒与出队的批量大小以及定时器的唤醒合并，可在运行时切换
+/// </summary>
+enum class EM_SchedulingProfile
+{
+    Balanced,   ///< 自适应自旋后休眠，每次提交唤醒一个线程（默认）
+    LowLatency, ///< 空闲线程长时间热自旋且不随空闲减少自旋，专用线程同样长时间自旋，定时器不合并唤醒
+    Throughput, ///< 有线程自旋等待任务时积压到一批任务才额外唤醒休眠线程，工作线程从共享队列一次取出一批任务
+    Efficiency  ///< 空闲线程不自旋直接休眠，定时器唤醒按16毫秒对齐合并，减少CPU唤醒次数
+};
+
+/// <summary>
+/// 任务提交结果枚举，TryPost/TrySubmit通过返回值报告，不抛出异常
+/// </summary>
+enum class EM_SubmitStatus
+{
+    Accepted,   ///< 已入队
+    CallerRan,  ///< 队列已满，已在提交线程上执行
+    Rejected,   ///< 队列已满，任务被丢弃
+    Timeout,    ///< 阻塞等待超时，任务被丢弃
+    Stopped     ///< 线程池已停止
+};
+
 /// <summary>
 /// 线程池配置结构体
 /// </summary>
@@ -36,8 +103,19 @@ struct ST_ThreadPoolConfig
 {
     size_t m_minThreads; ///< 最小线程数
     size_t m_maxThreads; ///< 最大线程数
-    size_t m_maxQueueSize; ///< 最大队列大小
+    size_t m_maxQueueSize; ///< 最大队列大小，全局队列、分区本地队列与提交分片合计不超过该值；工作线程本地队列与收件箱不计入
     size_t m_keepAliveTime; ///< 空闲线程保持时间(毫秒)
+    EM_SchedulerMode m_schedulerMode; ///< 调度模式
+    EM_PriorityPolicy m_priorityPolicy; ///< 优先级出队策略
+    size_t m_agingThreshold; ///< 老化阈值(毫秒)，低优先级任务等待超过该时间后每8次出队至少获得一次机会，0表示禁用
+    EM_OverloadPolicy m_overloadPolicy; ///< 队列已满时的过载策略
+    size_t m_overloadTimeout; ///< Block策略的最长等待时间(毫秒)
+    std::vector<int> m_cpuSet; ///< 工作线程可运行的CPU编号，为空表示不限制
+    bool m_numaAware; ///< 是否按NUMA节点划分工作线程：工作线程只在所属节点的CPU上运行，普通及以下优先级任务进入提交者所在节点的本地队列
+    std::string m_threadNamePrefix; ///< 工作线程与控制线程的名称前缀，为空时不设置名称
+    size_t m_maxBlockingThreads; ///< 工作线程在ScopedBlocking中阻塞时临时增加的补偿线程上限，可超出m_maxThreads，0表示不补偿
+    size_t m_submitShards; ///< 提交分片数：普通及以下优先级任务按提交线程分散到各分片，工作线程轮流取出；0表示按硬件线程数选择，1表示不分片
+    EM_SchedulingProfile m_schedulingProfile; ///< 调度配置档
 
     /// <summary>
     /// 构造函数，初始化默认配置
@@ -47,6 +125,15 @@ struct ST_ThreadPoolConfig
         , m_maxThreads(std::thread::hardware_concurrency())
         , m_maxQueueSize(10000)
         , m_keepAliveTime(60000) // 1分钟
+        , m_schedulerMode(EM_SchedulerMode::GlobalQueue)
+        , m_priorityPolicy(EM_PriorityPolicy::Strict)
+        , m_agingThreshold(200)
+        , m_overloadPolicy(EM_OverloadPolicy::Throw)
+        , m_overloadTimeout(1000)
+        , m_numaAware(false)
+        , m_maxBlockingThreads(64)
+        , m_submitShards(0)
+        , m_schedulingProfile(EM_SchedulingProfile::Balanced)
     {
     }
 };
@@ -56,9 +143,21 @@ struct ST_ThreadPoolConfig
 /// </summary>
 struct ST_Task
 {
-    std::function<void()> m_func; ///< 任务函数
+    TaskFunction m_func; ///< 任务函数
     EM_TaskPriority m_priority; ///< 任务优先级
     std::chrono::steady_clock::time_point m_submitTime;  ///< 提交时间
+    CancellationToken m_token; ///< 取消令牌，出队时已取消的任务不执行
+    std::chrono::steady_clock::time_point m_deadline{std::chrono::steady_clock::time_point::max()}; ///< 截止时间，出队时已超过的任务不执行
+    bool m_evictable{true}; ///< 能否被DropOldestLowest策略挤出；续接、协程恢复等经PostOrRun投递的内部任务为false
+
+    /// <summary>
+    /// 任务是否已取消或超过截止时间
+    /// </summary>
+    /// <param name="now">当前时间</param>
+    bool IsCancelled(std::chrono::steady_clock::time_point now) const
+    {
+        return now > m_deadline || m_token.IsCancellationRequested();
+    }
 
     /// <summary>
     /// 任务比较函数，用于优先级队列
@@ -75,57 +174,234 @@ struct ST_Task
 };
 
 /// <summary>
-/// 无锁任务队列实现
+/// 缓存行大小，用于隔离高频写入的原子变量，避免伪共享
+/// </summary>
+constexpr size_t THREAD_POOL_CACHE_LINE_SIZE = 64;
+
+/// <summary>
+/// 无锁任务队列实现（多生产者多消费者有界队列）
+/// 每个槽位带有序列号：生产者通过CAS抢占m_tail，消费者通过CAS抢占m_head，
+/// 槽位序列号保证同一槽位的写入与读取严格交替，不会丢失或重复取出任务
 /// </summary>
 class LockFreeTaskQueue {
 private:
-    static constexpr size_t QUEUE_SIZE = 10000;
-    std::array<ST_Task, QUEUE_SIZE> m_buffer;
-    std::atomic<size_t> m_head{0};
-    std::atomic<size_t> m_tail{0};
+    /// <summary>
+    /// 队列槽位
+    /// </summary>
+    struct ST_QueueSlot
+    {
+        std::atomic<size_t> m_sequence{0};     ///< 槽位序列号
+        std::atomic<int64_t> m_enqueueTicks{0}; ///< 任务提交时间，供老化检查无锁读取
+        ST_Task m_task;                        ///< 任务数据
+    };
 
 public:
+    static constexpr size_t DEFAULT_CAPACITY = 16384; ///< 默认容量（必须为2的幂）
+
     /// <summary>
-    /// 尝试将任务推入队列
+    /// 构造函数
     /// </summary>
-    bool try_push(const ST_Task& task) {
-        size_t tail = m_tail.load(std::memory_order_relaxed);
-        size_t next_tail = (tail + 1) % QUEUE_SIZE;
-        
-        if (next_tail == m_head.load(std::memory_order_acquire)) {
-            return false; // 队列已满
-        }
-        
-        m_buffer[tail] = task;
-        m_tail.store(next_tail, std::memory_order_release);
+    /// <param name="capacity">队列容量，向上取整为2的幂</param>
+    explicit LockFreeTaskQueue(size_t capacity = DEFAULT_CAPACITY)
+    {
+        size_t actualCapacity = 2;
+        while (actualCapacity < capacity)
+        {
+            actualCapacity <<= 1;
+        }
+
+        m_capacity = actualCapacity;
+        m_mask = actualCapacity - 1;
+        m_buffer = std::make_unique<ST_QueueSlot[]>(actualCapacity);
+        for (size_t i = 0; i < actualCapacity; ++i)
+        {
+            m_buffer[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // 禁用拷贝构造和赋值
+    LockFreeTaskQueue(const LockFreeTaskQueue&) = delete;
+    LockFreeTaskQueue& operator=(const LockFreeTaskQueue&) = delete;
+
+    /// <summary>
+    /// 尝试将任务推入队列，可被任意线程并发调用
+    /// </summary>
+    bool try_push(ST_Task&& task) {
+        ST_QueueSlot* slot = nullptr;
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot = &m_buffer[pos & m_mask];
+            size_t seq = slot->m_sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // 队列已满
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->m_enqueueTicks.store(task.m_submitTime.time_since_epoch().count(), std::memory_order_relaxed);
+        slot->m_task = std::move(task);
+        slot->m_sequence.store(pos + 1, std::memory_order_release);
         return true;
     }
 
     /// <summary>
-    /// 尝试从队列中取出任务
+    /// 尝试从队列中取出任务，可被任意线程并发调用
     /// </summary>
     bool try_pop(ST_Task& task) {
-        size_t head = m_head.load(std::memory_order_relaxed);
-        
-        if (head == m_tail.load(std::memory_order_acquire)) {
-            return false; // 队列为空
+        ST_QueueSlot* slot = nullptr;
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            slot = &m_buffer[pos & m_mask];
+            size_t seq = slot->m_sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // 队列为空
+            }
+            else
+            {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        task = std::move(slot->m_task);
+        slot->m_task.m_func = nullptr; // 及时释放任务捕获的资源
+        slot->m_sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    /// <summary>
+    /// 批量推入任务，可被任意线程并发调用；从队尾数出连续的空闲槽位后用一次CAS全部预留，
+    /// 队列剩余空间不足时只推入前面的一部分
+    /// </summary>
+    /// <returns>推入的任务数，即tasks中被取走的前缀长度</returns>
+    size_t try_push_bulk(std::span<ST_Task> tasks) {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (true)
+        {
+            // 槽位序列号等于其位置时空闲，且在该位置被预留之前不会改变
+            count = 0;
+            while (count < tasks.size() && m_buffer[(pos + count) & m_mask].m_sequence.load(std::memory_order_acquire) == pos + count)
+            {
+                ++count;
+            }
+
+            if (count > 0)
+            {
+                if (m_tail.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                {
+                    break;
+                }
+                continue;
+            }
+
+            size_t seq = m_buffer[pos & m_mask].m_sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0)
+            {
+                return 0; // 队列已满
+            }
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            ST_QueueSlot& slot = m_buffer[(pos + i) & m_mask];
+            slot.m_enqueueTicks.store(tasks[i].m_submitTime.time_since_epoch().count(), std::memory_order_relaxed);
+            slot.m_task = std::move(tasks[i]);
+            slot.m_sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /// <summary>
+    /// 批量取出任务，可被任意线程并发调用；从队首数出连续的已发布任务后用一次CAS全部取走
+    /// </summary>
+    /// <param name="tasks">输出缓冲，最多取出其长度个任务</param>
+    /// <returns>取出的任务数</returns>
+    size_t try_pop_bulk(std::span<ST_Task> tasks) {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        size_t count = 0;
+        while (true)
+        {
+            // 已发布的槽位序列号为位置加1，且在该位置被取走之前不会改变
+            count = 0;
+            while (count < tasks.size() && m_buffer[(pos + count) & m_mask].m_sequence.load(std::memory_order_acquire) == pos + count + 1)
+            {
+                ++count;
+            }
+
+            if (count > 0)
+            {
+                if (m_head.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+                {
+                    break;
+                }
+                continue;
+            }
+
+            size_t seq = m_buffer[pos & m_mask].m_sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+            {
+                return 0; // 队列为空
+            }
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            ST_QueueSlot& slot = m_buffer[(pos + i) & m_mask];
+            tasks[i] = std::move(slot.m_task);
+            slot.m_task.m_func = nullptr; // 及时释放任务捕获的资源
+            slot.m_sequence.store(pos + i + m_capacity, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /// <summary>
+    /// 读取队首任务的提交时间（并发修改时为近似值）
+    /// </summary>
+    /// <param name="ticks">输出steady_clock计数</param>
+    /// <returns>队列非空时返回true</returns>
+    bool try_peek_enqueue_ticks(int64_t& ticks) const {
+        size_t pos = m_head.load(std::memory_order_acquire);
+        const ST_QueueSlot& slot = m_buffer[pos & m_mask];
+        if (slot.m_sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            return false;
         }
-        
-        task = m_buffer[head];
-        m_head.store((head + 1) % QUEUE_SIZE, std::memory_order_release);
+        ticks = slot.m_enqueueTicks.load(std::memory_order_relaxed);
         return true;
     }
 
     /// <summary>
-    /// 获取队列大小
+    /// 获取队列大小（并发修改时为近似值）
     /// </summary>
     size_t size() const {
         size_t head = m_head.load(std::memory_order_relaxed);
         size_t tail = m_tail.load(std::memory_order_relaxed);
-        if (tail >= head) {
-            return tail - head;
-        }
-        return QUEUE_SIZE - (head - tail);
+        return tail > head ? tail - head : 0;
     }
 
     /// <summary>
@@ -134,211 +410,2752 @@ public:
     bool empty() const {
         return size() == 0;
     }
-};
 
-/// <summary>
-/// 专用线程状态枚举
-/// </summary>
-enum class EM_DedicatedThreadState
-{
-    Running,    ///< 运行中
-    Stopped,    ///< 已停止
-    Error       ///< 发生错误
+    /// <summary>
+    /// 获取队列容量
+    /// </summary>
+    size_t capacity() const {
+        return m_capacity;
+    }
+
+private:
+    std::unique_ptr<ST_QueueSlot[]> m_buffer; ///< 槽位数组
+    size_t m_capacity{0};                     ///< 队列容量
+    size_t m_mask{0};                         ///< 下标掩码
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<size_t> m_head{0}; ///< 消费位置（独占缓存行）
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0}; ///< 生产位置（独占缓存行）
 };
 
 /// <summary>
-/// 专用线程信息结构体
+/// 可增长的分段任务队列（多生产者多消费者）
+/// 由若干个容量依次翻倍的LockFreeTaskQueue段组成：生产者写入最新的段，写满时在互斥锁内追加一个两倍容量的新段；
+/// 消费者从最早的段开始取任务。生产者只写最新的段，旧段取空后不再写入，但保留到队列销毁才释放，
+/// 因此突发流量后的内存占用不会回落；之后的任务写入已分配的最新（也是最大的）段，推入路径上不会重复分配
 /// </summary>
-struct ST_DedicatedThreadInfo
-{
-    std::thread m_thread;                    ///< 线程对象
-    std::atomic<EM_DedicatedThreadState> m_state{EM_DedicatedThreadState::Running}; ///< 线程状态
-    std::string m_name;                      ///< 线程名称
-    std::function<void()> m_task;            ///< 任务函数
-    std::mutex m_mutex;                      ///< 互斥锁
-    std::condition_variable m_condition;     ///< 条件变量
-    bool m_stop{false};                      ///< 停止标志
+class SegmentedTaskQueue {
+public:
+    static constexpr size_t INITIAL_SEGMENT_CAPACITY = 1024; ///< 第一段容量
+    static constexpr size_t MAX_SEGMENTS = 32;               ///< 段数上限
 
     /// <summary>
-    /// 默认构造函数
+    /// 构造函数，分配第一段
     /// </summary>
-    ST_DedicatedThreadInfo() = default;
+    /// <param name="initialCapacity">第一段容量，之后每段翻倍</param>
+    explicit SegmentedTaskQueue(size_t initialCapacity = INITIAL_SEGMENT_CAPACITY)
+    {
+        m_ownedSegments.push_back(std::make_unique<LockFreeTaskQueue>(initialCapacity));
+        m_segments[0].store(m_ownedSegments.back().get(), std::memory_order_relaxed);
+        m_segmentCount.store(1, std::memory_order_relaxed);
+    }
+
+    // 禁用拷贝构造和赋值
+    SegmentedTaskQueue(const SegmentedTaskQueue&) = delete;
+    SegmentedTaskQueue& operator=(const SegmentedTaskQueue&) = delete;
 
     /// <summary>
-    /// 移动构造函数
+    /// 推入任务，最新段已满时追加新段；仅在段数达到上限时失败（失败时任务保持不变）
     /// </summary>
-    ST_DedicatedThreadInfo(ST_DedicatedThreadInfo&& other) noexcept
-        : m_thread(std::move(other.m_thread))
-        , m_state(other.m_state.load())
-        , m_name(std::move(other.m_name))
-        , m_task(std::move(other.m_task))
-        , m_stop(other.m_stop)
-    {
+    bool try_push(ST_Task&& task) {
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        while (true)
+        {
+            size_t segmentCount = m_segmentCount.load(std::memory_order_acquire);
+            LockFreeTaskQueue* tail = m_segments[segmentCount - 1].load(std::memory_order_acquire);
+            if (tail->try_push(std::move(task)))
+            {
+                return true;
+            }
+            if (!grow(segmentCount))
+            {
+                m_count.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
     }
 
     /// <summary>
-    /// 移动赋值运算符
+    /// 批量推入任务，最新段放不下时追加新段继续推入；仅在段数达到上限时推入不完整
     /// </summary>
-    ST_DedicatedThreadInfo& operator=(ST_DedicatedThreadInfo&& other) noexcept
-    {
-        if (this != &other)
+    /// <returns>推入的任务数，即tasks中被取走的前缀长度</returns>
+    size_t try_push_bulk(std::span<ST_Task> tasks) {
+        m_count.fetch_add(tasks.size(), std::memory_order_relaxed);
+        size_t pushed = 0;
+        while (pushed < tasks.size())
         {
-            m_thread = std::move(other.m_thread);
-            m_state = other.m_state.load();
-            m_name = std::move(other.m_name);
-            m_task = std::move(other.m_task);
-            m_stop = other.m_stop;
+            size_t segmentCount = m_segmentCount.load(std::memory_order_acquire);
+            LockFreeTaskQueue* tail = m_segments[segmentCount - 1].load(std::memory_order_acquire);
+            size_t count = tail->try_push_bulk(tasks.subspan(pushed));
+            pushed += count;
+            if (count == 0 && !grow(segmentCount))
+            {
+                m_count.fetch_sub(tasks.size() - pushed, std::memory_order_relaxed);
+                break;
+            }
         }
-        return *this;
+        return pushed;
     }
 
-    // 禁用拷贝构造和赋值
-    ST_DedicatedThreadInfo(const ST_DedicatedThreadInfo&) = delete;
-    ST_DedicatedThreadInfo& operator=(const ST_DedicatedThreadInfo&) = delete;
-};
-
-/// <summary>
-/// 线程池类，提供基于优先级的任务调度功能
-/// </summary>
-class SDK_API ThreadPool
-{
-public:
     /// <summary>
-    /// 构造函数
+    /// 从最早的非空段开始批量取出任务
     /// </summary>
-    /// <param name="config">线程池配置</param>
-    explicit ThreadPool(const ST_ThreadPoolConfig& config = ST_ThreadPoolConfig());
+    /// <param name="tasks">输出缓冲，最多取出其长度个任务</param>
+    /// <returns>取出的任务数</returns>
+    size_t try_pop_bulk(std::span<ST_Task> tasks) {
+        if (m_count.load(std::memory_order_acquire) == 0)
+        {
+            return 0;
+        }
+
+        size_t popped = 0;
+        size_t segmentCount = m_segmentCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < segmentCount && popped < tasks.size(); ++i)
+        {
+            popped += m_segments[i].load(std::memory_order_acquire)->try_pop_bulk(tasks.subspan(popped));
+        }
+        if (popped > 0)
+        {
+            m_count.fetch_sub(popped, std::memory_order_relaxed);
+        }
+        return popped;
+    }
 
     /// <summary>
-    /// 析构函数
+    /// 从最早的非空段取出任务
     /// </summary>
-    ~ThreadPool();
+    bool try_pop(ST_Task& task) {
+        if (m_count.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+
+        size_t segmentCount = m_segmentCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < segmentCount; ++i)
+        {
+            if (m_segments[i].load(std::memory_order_acquire)->try_pop(task))
+            {
+                m_count.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
 
     /// <summary>
-    /// 提交任务到线程池
+    /// 读取最早的非空段队首任务的提交时间（并发修改时为近似值）
     /// </summary>
-    /// <param name="task">任务函数</param>
-    /// <param name="priority">任务优先级</param>
-    /// <returns>future对象，用于获取任务结果</returns>
-    template <typename F>
-    auto Submit(F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal) 
-        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
-    {
-        using return_type = decltype(std::declval<std::decay_t<F>>()());
+    bool try_peek_enqueue_ticks(int64_t& ticks) const {
+        if (m_count.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
 
-        auto task = std::make_shared<std::packaged_task<return_type()>>(std::forward<F>(f));
-        std::future<return_type> res = task->get_future();
-        
-        if (m_stop)
+        size_t segmentCount = m_segmentCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < segmentCount; ++i)
         {
-            throw std::runtime_error("ThreadPool is stopped");
+            if (m_segments[i].load(std::memory_order_acquire)->try_peek_enqueue_ticks(ticks))
+            {
+                return true;
+            }
         }
+        return false;
+    }
 
-        ST_Task taskWrapper;
-        taskWrapper.m_func = [task]() { (*task)(); };
-        taskWrapper.m_priority = priority;
-        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+    /// <summary>
+    /// 获取任务数（并发修改时为近似值）
+    /// </summary>
+    size_t size() const {
+        return m_count.load(std::memory_order_relaxed);
+    }
 
-        if (!m_tasks.try_push(std::move(taskWrapper)))
+    /// <summary>
+    /// 获取已分配的总容量
+    /// </summary>
+    size_t capacity() const {
+        size_t total = 0;
+        size_t segmentCount = m_segmentCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < segmentCount; ++i)
         {
-            throw std::runtime_error("Task queue is full");
+            total += m_segments[i].load(std::memory_order_acquire)->capacity();
         }
-
-        m_condition.notify_one();
-        return res;
+        return total;
     }
 
+private:
     /// <summary>
-    /// 获取当前线程数
+    /// 追加新段；其他线程已经追加过时直接返回
     /// </summary>
-    /// <returns>当前线程数</returns>
-    size_t GetCurrentThreadCount() const { return m_totalThreads.load(); }
+    /// <param name="observedCount">调用者看到的段数</param>
+    /// <returns>是否可以重试推入</returns>
+    bool grow(size_t observedCount) {
+        std::lock_guard<std::mutex> lock(m_growMutex);
+        size_t segmentCount = m_segmentCount.load(std::memory_order_relaxed);
+        if (segmentCount != observedCount)
+        {
+            return true;
+        }
+        if (segmentCount >= MAX_SEGMENTS)
+        {
+            return false;
+        }
+
+        size_t capacity = m_ownedSegments.back()->capacity() * 2;
+        m_ownedSegments.push_back(std::make_unique<LockFreeTaskQueue>(capacity));
+        m_segments[segmentCount].store(m_ownedSegments.back().get(), std::memory_order_release);
+        m_segmentCount.store(segmentCount + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<std::atomic<LockFreeTaskQueue*>, MAX_SEGMENTS> m_segments{};     ///< 各段，按创建顺序排列
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<size_t> m_segmentCount{0}; ///< 已发布的段数
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<size_t> m_count{0};        ///< 任务数
+    std::mutex m_growMutex;                                                     ///< 追加新段互斥锁
+    std::vector<std::unique_ptr<LockFreeTaskQueue>> m_ownedSegments;            ///< 段的所有权（受m_growMutex保护）
+};
+
+/// <summary>
+/// 多优先级任务队列，每个优先级对应一条独立的无锁通道
+/// </summary>
+class PriorityTaskQueue {
+public:
+    static constexpr size_t PRIORITY_LEVELS = 4; ///< 优先级数量
+    static constexpr uint32_t AGED_POP_INTERVAL = 8; ///< 每个线程每该次数的出队中最多有一次按老化取出
 
     /// <summary>
-    /// 获取当前任务数
+    /// 构造函数
     /// </summary>
-    /// <returns>当前任务数</returns>
-    size_t GetTaskCount() { return m_tasks.size(); }
+    /// <param name="maxSize">所有通道合计的任务数上限</param>
+    /// <param name="laneCapacity">每条通道第一段的容量，通道按需翻倍增长</param>
+    explicit PriorityTaskQueue(size_t maxSize = SIZE_MAX, size_t laneCapacity = SegmentedTaskQueue::INITIAL_SEGMENT_CAPACITY)
+        : m_maxSize(maxSize)
+    {
+        for (auto& lane : m_lanes)
+        {
+            lane = std::make_unique<SegmentedTaskQueue>(laneCapacity);
+        }
+    }
 
     /// <summary>
-    /// 调整线程池大小
+    /// 设置所有通道合计的任务数上限，可在运行时调整；并发推入时可能短暂超出不多于并发生产者数
     /// </summary>
-    /// <param name="minThreads">最小线程数</param>
-    /// <param name="maxThreads">最大线程数</param>
-    void Resize(size_t minThreads, size_t maxThreads);
+    void set_max_size(size_t maxSize) {
+        m_maxSize.store(maxSize, std::memory_order_relaxed);
+    }
 
     /// <summary>
-    /// 等待所有任务完成
+    /// 获取任务数上限
     /// </summary>
-    void WaitAll();
+    size_t max_size() const {
+        return m_maxSize.load(std::memory_order_relaxed);
+    }
 
     /// <summary>
-    /// 停止线程池
+    /// 设置出队策略
     /// </summary>
-    void Shutdown();
+    /// <param name="policy">出队策略</param>
+    /// <param name="agingThreshold">老化阈值，0表示禁用</param>
+    void configure(EM_PriorityPolicy policy, std::chrono::milliseconds agingThreshold) {
+        m_policy = policy;
+        m_agingTicks = std::chrono::duration_cast<std::chrono::steady_clock::duration>(agingThreshold).count();
+    }
 
     /// <summary>
-    /// 创建专用线程
+    /// 按任务优先级推入对应通道，达到上限时失败（失败时任务保持不变）
     /// </summary>
-    /// <param name="name">线程名称</param>
-    /// <param name="task">任务函数</param>
-    /// <returns>线程ID，用于后续管理</returns>
-    size_t CreateDedicatedThread(const std::string& name, std::function<void()> task);
+    bool try_push(ST_Task&& task) {
+        if (size() >= m_maxSize.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+        return m_lanes[LaneIndex(task.m_priority)]->try_push(std::move(task));
+    }
 
     /// <summary>
-    /// 停止专用线程
+    /// 批量推入同一优先级的任务，最多推入到任务数上限为止
     /// </summary>
-    /// <param name="threadId">线程ID</param>
-    /// <returns>是否成功停止</returns>
-    bool StopDedicatedThread(size_t threadId);
+    /// <param name="priority">任务优先级，所有任务的m_priority均应为该值</param>
+    /// <param name="tasks">待推入的任务</param>
+    /// <returns>推入的任务数，即tasks中被取走的前缀长度</returns>
+    size_t try_push_bulk(EM_TaskPriority priority, std::span<ST_Task> tasks) {
+        size_t current = size();
+        size_t maxSize = m_maxSize.load(std::memory_order_relaxed);
+        if (current >= maxSize)
+        {
+            return 0;
+        }
+        return m_lanes[LaneIndex(priority)]->try_push_bulk(tasks.first((std::min)(tasks.size(), maxSize - current)));
+    }
 
     /// <summary>
-    /// 获取专用线程状态
+    /// 从不高于指定优先级的最低优先级通道取出最早的可挤出任务，供DropOldestLowest策略腾出空位
+    /// 不可挤出的内部任务被移到所在通道末尾，每条通道最多检查一遍现有任务；内部任务在移动期间短暂不可见，
+    /// 调用者需要在之后唤醒工作线程
     /// </summary>
-    /// <param name="threadId">线程ID</param>
-    /// <returns>线程状态</returns>
-    EM_DedicatedThreadState GetDedicatedThreadState(size_t threadId) const;
+    bool try_pop_lowest(EM_TaskPriority maxPriority, ST_Task& task) {
+        for (size_t i = 0; i <= LaneIndex(maxPriority); ++i)
+        {
+            SegmentedTaskQueue& lane = *m_lanes[i];
+            for (size_t checked = 0, count = lane.size(); checked < count && lane.try_pop(task); ++checked)
+            {
+                // 通道只在段数达到上限时推入失败，此时只能交给调用者丢弃
+                if (task.m_evictable || !lane.try_push(std::move(task)))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
 
     /// <summary>
-    /// 获取所有专用线程信息
+    /// 按出队策略取出任务，每AGED_POP_INTERVAL次出队中有一次先取等待超过老化阈值的低优先级任务
     /// </summary>
-    /// <returns>专用线程信息列表</returns>
-    std::vector<std::pair<size_t, ST_DedicatedThreadInfo>> GetAllDedicatedThreads() const;
+    bool try_pop(ST_Task& task) {
+        // 持续积压时所有通道的队首都会超过阈值，老化出队必须限频，否则低优先级反过来压住高优先级
+        static thread_local uint32_t agingTick = 0;
+        if (m_agingTicks > 0 && agingTick++ % AGED_POP_INTERVAL == 0 && try_pop_aged(task))
+        {
+            return true;
+        }
+
+        if (m_policy == EM_PriorityPolicy::Weighted)
+        {
+            // 15个出队机会中 Critical占8个、High占4个、Normal占2个、Low占1个
+            static thread_local uint32_t tick = 0;
+            uint32_t slot = tick++ % 15;
+            size_t preferred = slot < 8 ? 3 : (slot < 12 ? 2 : (slot < 14 ? 1 : 0));
+            if (m_lanes[preferred]->try_pop(task))
+            {
+                return true;
+            }
+        }
+
+        for (size_t i = PRIORITY_LEVELS; i-- > 0;)
+        {
+            if (m_lanes[i]->try_pop(task))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 
-private:
     /// <summary>
-    /// 工作线程函数
+    /// 从指定优先级通道取出任务
     /// </summary>
-    void WorkerThread();
+    bool try_pop_lane(EM_TaskPriority priority, ST_Task& task) {
+        return m_lanes[LaneIndex(priority)]->try_pop(task);
+    }
 
     /// <summary>
-    /// 调整工作线程数量
+    /// 从指定优先级通道批量取出任务
     /// </summary>
-    void AdjustThreadCount();
+    /// <param name="priority">通道优先级</param>
+    /// <param name="tasks">输出缓冲，最多取出其长度个任务</param>
+    /// <returns>取出的任务数</returns>
+    size_t try_pop_lane_bulk(EM_TaskPriority priority, std::span<ST_Task> tasks) {
+        return m_lanes[LaneIndex(priority)]->try_pop_bulk(tasks);
+    }
 
     /// <summary>
-    /// 创建新的工作线程
+    /// 获取指定优先级通道的任务数
     /// </summary>
-    void CreateWorkerThread();
+    size_t lane_size(EM_TaskPriority priority) const {
+        return m_lanes[LaneIndex(priority)]->size();
+    }
 
     /// <summary>
-    /// 专用线程工作函数
+    /// 获取所有通道的任务数
     /// </summary>
-    /// <param name="threadInfo">线程信息</param>
-    void DedicatedThreadWorker(std::shared_ptr<ST_DedicatedThreadInfo> threadInfo);
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& lane : m_lanes)
+        {
+            total += lane->size();
+        }
+        return total;
+    }
 
-private:
-    std::vector<std::thread> m_workers; ///< 工作线程集合
-    LockFreeTaskQueue m_tasks; ///< 无锁任务队列
-    mutable std::shared_mutex m_configMutex; ///< 配置互斥锁
+    /// <summary>
+    /// 读取所有通道中最早入队任务的提交时间（并发修改时为近似值）
+    /// </summary>
+    bool try_peek_oldest_ticks(int64_t& ticks) const {
+        bool found = false;
+        for (const auto& lane : m_lanes)
+        {
+            int64_t laneTicks = 0;
+            if (lane->try_peek_enqueue_ticks(laneTicks) && (!found || laneTicks < ticks))
+            {
+                ticks = laneTicks;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /// <summary>
+    /// 优先级转换为通道下标
+    /// </summary>
+    static size_t LaneIndex(EM_TaskPriority priority) {
+        return static_cast<size_t>(priority) & (PRIORITY_LEVELS - 1);
+    }
+
+    /// <summary>
+    /// 检查所有通道是否为空
+    /// </summary>
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    /// <summary>
+    /// 取出队首等待时间超过老化阈值的非Critical任务，多条通道超过阈值时取队首等待最久的通道
+    /// </summary>
+    bool try_pop_aged(ST_Task& task) {
+        int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        size_t oldest = PRIORITY_LEVELS;
+        int64_t oldestTicks = 0;
+        for (size_t i = 0; i + 1 < PRIORITY_LEVELS; ++i)
+        {
+            int64_t enqueueTicks = 0;
+            if (m_lanes[i]->try_peek_enqueue_ticks(enqueueTicks) && now - enqueueTicks > m_agingTicks
+                && (oldest == PRIORITY_LEVELS || enqueueTicks < oldestTicks))
+            {
+                oldest = i;
+                oldestTicks = enqueueTicks;
+            }
+        }
+        return oldest != PRIORITY_LEVELS && m_lanes[oldest]->try_pop(task);
+    }
+
+private:
+    std::array<std::unique_ptr<SegmentedTaskQueue>, PRIORITY_LEVELS> m_lanes; ///< 各优先级通道
+    EM_PriorityPolicy m_policy{EM_PriorityPolicy::Strict};                  ///< 出队策略
+    int64_t m_agingTicks{0};                                                ///< 老化阈值(steady_clock计数)
+    std::atomic<size_t> m_maxSize;                                          ///< 所有通道合计的任务数上限
+};
+
+/// <summary>
+/// 延迟直方图，按2的幂划分区间并在每个区间内细分4档，用于估算分位数
+/// </summary>
+class LatencyHistogram
+{
+public:
+    static constexpr size_t SUB_BUCKETS = 4;                 ///< 每个2的幂区间的细分档数
+    static constexpr size_t BUCKET_COUNT = 64 * SUB_BUCKETS; ///< 总档数
+
+    /// <summary>
+    /// 记录一次延迟
+    /// </summary>
+    /// <param name="nanoseconds">延迟(纳秒)</param>
+    void Record(uint64_t nanoseconds)
+    {
+        m_buckets[BucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+        uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+        while (nanoseconds > currentMax && !m_max.compare_exchange_weak(currentMax, nanoseconds, std::memory_order_relaxed)) {}
+    }
+
+    /// <summary>
+    /// 获取记录次数
+    /// </summary>
+    uint64_t Count() const { return m_count.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 获取平均延迟(纳秒)
+    /// </summary>
+    double Mean() const
+    {
+        uint64_t count = Count();
+        return count > 0 ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / count : 0.0;
+    }
+
+    /// <summary>
+    /// 获取最大延迟(纳秒)
+    /// </summary>
+    uint64_t Max() const { return m_max.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 估算分位数延迟(纳秒)，返回所在档位的上界
+    /// </summary>
+    /// <param name="quantile">分位数，取值0~1</param>
+    uint64_t Percentile(double quantile) const
+    {
+        uint64_t count = Count();
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(quantile * count);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen > target)
+            {
+                return (std::min)(BucketUpperBound(i), Max());
+            }
+        }
+        return Max();
+    }
+
+    /// <summary>
+    /// 清空统计
+    /// </summary>
+    void Reset()
+    {
+        for (auto& bucket : m_buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sum.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    /// <summary>
+    /// 累加另一个直方图的记录，用于把各线程的直方图汇总为快照
+    /// </summary>
+    /// <param name="other">来源直方图</param>
+    void Merge(const LatencyHistogram& other)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            uint64_t bucketCount = other.m_buckets[i].load(std::memory_order_relaxed);
+            if (bucketCount > 0)
+            {
+                m_buckets[i].fetch_add(bucketCount, std::memory_order_relaxed);
+            }
+        }
+        m_count.fetch_add(other.m_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_sum.fetch_add(other.m_sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        uint64_t otherMax = other.Max();
+        uint64_t currentMax = m_max.load(std::memory_order_relaxed);
+        while (otherMax > currentMax && !m_max.compare_exchange_weak(currentMax, otherMax, std::memory_order_relaxed)) {}
+    }
+
+private:
+    /// <summary>
+    /// 计算延迟所在档位
+    /// </summary>
+    static size_t BucketIndex(uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        size_t exponent = 63;
+        while ((value >> exponent) == 0)
+        {
+            --exponent;
+        }
+        size_t subBucket = static_cast<size_t>((value >> (exponent - 2)) & (SUB_BUCKETS - 1));
+        return exponent * SUB_BUCKETS + subBucket;
+    }
+
+    /// <summary>
+    /// 计算档位上界
+    /// </summary>
+    static uint64_t BucketUpperBound(size_t index)
+    {
+        size_t exponent = index / SUB_BUCKETS;
+        size_t subBucket = index % SUB_BUCKETS;
+        if (exponent < 2)
+        {
+            return index;
+        }
+        uint64_t base = uint64_t(1) << exponent;
+        uint64_t step = base / SUB_BUCKETS;
+        return base + step * (subBucket + 1) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_buckets{}; ///< 各档计数
+    std::atomic<uint64_t> m_count{0};                            ///< 总次数
+    std::atomic<uint64_t> m_sum{0};                              ///< 延迟总和
+    std::atomic<uint64_t> m_max{0};                              ///< 最大延迟
+};
+
+/// <summary>
+/// 单个优先级的排队等待统计结果
+/// </summary>
+struct ST_PriorityWaitStats
+{
+    uint64_t m_count{0};     ///< 已出队任务数
+    double m_avgWaitUs{0};   ///< 平均等待时间(微秒)
+    double m_p50WaitUs{0};   ///< P50等待时间(微秒)
+    double m_p99WaitUs{0};   ///< P99等待时间(微秒)
+    double m_p999WaitUs{0};  ///< P99.9等待时间(微秒)
+    double m_maxWaitUs{0};   ///< 最大等待时间(微秒)
+};
+
+/// <summary>
+/// 延迟分布摘要
+/// </summary>
+struct ST_LatencySummary
+{
+    uint64_t m_count{0};  ///< 记录次数
+    double m_avgUs{0};    ///< 平均值(微秒)
+    double m_p50Us{0};    ///< P50(微秒)
+    double m_p99Us{0};    ///< P99(微秒)
+    double m_p999Us{0};   ///< P99.9(微秒)
+    double m_maxUs{0};    ///< 最大值(微秒)
+};
+
+/// <summary>
+/// 单个线程的运行统计，按缓存行对齐
+/// 工作线程只写自己槽位中的实例，非工作线程只写自己的本地状态，提交与执行路径上不会与其他线程竞争同一缓存行；GetStats时再汇总为快照
+/// </summary>
+struct alignas(THREAD_POOL_CACHE_LINE_SIZE) ST_ThreadStats
+{
+    /// <summary>
+    /// 单个优先级的计数与直方图
+    /// </summary>
+    struct ST_PriorityCounters
+    {
+        std::atomic<uint64_t> m_submitted{0}; ///< 入队任务数
+        std::atomic<uint64_t> m_completed{0}; ///< 执行完毕的任务数
+        std::atomic<uint64_t> m_rejected{0};  ///< 因队列已满或等待超时被丢弃的任务数
+        std::atomic<uint64_t> m_cancelled{0}; ///< 出队时已取消或超过截止时间而未执行的任务数
+        LatencyHistogram m_queueWait;         ///< 排队等待时间
+        LatencyHistogram m_runTime;           ///< 执行时间
+    };
+
+    std::array<ST_PriorityCounters, PriorityTaskQueue::PRIORITY_LEVELS> m_priorities; ///< 各优先级统计，下标与EM_TaskPriority一致
+    std::atomic<uint64_t> m_steals{0};   ///< 窃取成功次数
+    std::atomic<uint64_t> m_parks{0};    ///< 进入休眠的次数
+    std::atomic<uint64_t> m_wakeups{0};  ///< 被定向唤醒的次数
+    std::atomic<uint64_t> m_enqueuedTasks{0}; ///< 本线程计入的入队任务数，与m_finishedTasks一起汇总出未完成任务数，不受Reset影响
+    std::atomic<uint64_t> m_finishedTasks{0}; ///< 本线程计入的执行完毕或丢弃的任务数，不受Reset影响
+
+    /// <summary>
+    /// 获取指定优先级的统计
+    /// </summary>
+    ST_PriorityCounters& Priority(EM_TaskPriority priority) { return m_priorities[PriorityTaskQueue::LaneIndex(priority)]; }
+
+    /// <summary>
+    /// 清空统计（与并发写入同时进行时结果为近似值）
+    /// </summary>
+    void Reset()
+    {
+        for (auto& counters : m_priorities)
+        {
+            counters.m_submitted.store(0, std::memory_order_relaxed);
+            counters.m_completed.store(0, std::memory_order_relaxed);
+            counters.m_rejected.store(0, std::memory_order_relaxed);
+            counters.m_cancelled.store(0, std::memory_order_relaxed);
+            counters.m_queueWait.Reset();
+            counters.m_runTime.Reset();
+        }
+        m_steals.store(0, std::memory_order_relaxed);
+        m_parks.store(0, std::memory_order_relaxed);
+        m_wakeups.store(0, std::memory_order_relaxed);
+    }
+};
+
+/// <summary>
+/// 单个优先级的统计快照
+/// </summary>
+struct ST_PriorityStats
+{
+    uint64_t m_submitted{0};        ///< 入队任务数
+    uint64_t m_completed{0};        ///< 执行完毕的任务数
+    uint64_t m_rejected{0};         ///< 被丢弃的任务数
+    uint64_t m_cancelled{0};        ///< 已取消或超时而未执行的任务数
+    ST_LatencySummary m_queueWait;  ///< 排队等待时间
+    ST_LatencySummary m_runTime;    ///< 执行时间
+};
+
+/// <summary>
+/// 线程池统计快照，由GetStats按需汇总各线程的统计生成
+/// </summary>
+struct ST_ThreadPoolStats
+{
+    size_t m_threadCount{0};        ///< 工作线程数
+    size_t m_activeThreads{0};      ///< 正在执行任务的线程数
+    size_t m_pendingTasks{0};       ///< 待执行任务数
+    size_t m_blockingThreads{0};    ///< 正在ScopedBlocking中阻塞的工作线程数
+    uint64_t m_compensations{0};    ///< 因工作线程阻塞而创建补偿线程的次数
+    uint64_t m_submitted{0};        ///< 入队任务数
+    uint64_t m_completed{0};        ///< 执行完毕的任务数
+    uint64_t m_rejected{0};         ///< 被丢弃的任务数
+    uint64_t m_cancelled{0};        ///< 已取消或超时而未执行的任务数
+    uint64_t m_steals{0};           ///< 窃取成功次数
+    uint64_t m_parks{0};            ///< 工作线程进入休眠的次数
+    uint64_t m_wakeups{0};          ///< 工作线程被定向唤醒的次数
+    ST_LatencySummary m_queueWait;  ///< 全部优先级的排队等待时间
+    ST_LatencySummary m_runTime;    ///< 全部优先级的执行时间
+    std::array<ST_PriorityStats, PriorityTaskQueue::PRIORITY_LEVELS> m_priorities; ///< 各优先级统计，下标与EM_TaskPriority一致
+};
+
+/// <summary>
+/// 过载统计结果
+/// </summary>
+struct ST_OverloadStats
+{
+    uint64_t m_rejected{0};    ///< 因队列已满或等待超时被丢弃的新任务数
+    uint64_t m_dropped{0};     ///< DropOldestLowest策略下被挤出队列的旧任务数
+    uint64_t m_callerRuns{0};  ///< 在提交线程上执行的任务数
+    uint64_t m_blocked{0};     ///< 需要阻塞等待空位的提交次数
+};
+
+/// <summary>
+/// 从任务内存块池创建堆上的任务对象，供工作窃取队列保存任务指针
+/// </summary>
+inline ST_Task* CreatePooledTask(ST_Task&& task)
+{
+    void* block = TaskBlockPool::Allocate(sizeof(ST_Task));
+    return ::new (block) ST_Task(std::move(task));
+}
+
+/// <summary>
+/// 销毁由CreatePooledTask创建的任务对象
+/// </summary>
+inline void DestroyPooledTask(ST_Task* task) noexcept
+{
+    task->~ST_Task();
+    TaskBlockPool::Deallocate(task, sizeof(ST_Task));
+}
+
+/// <summary>
+/// 工作窃取双端队列（Chase-Lev算法）
+/// 仅拥有者线程可以Push/Pop（后进先出，保持缓存局部性），其他线程通过Steal从另一端窃取
+/// </summary>
+class WorkStealingDeque
+{
+private:
+    /// <summary>
+    /// 环形缓冲区
+    /// </summary>
+    struct ST_DequeBuffer
+    {
+        size_t m_capacity;                                 ///< 容量（2的幂）
+        std::unique_ptr<std::atomic<ST_Task*>[]> m_items;  ///< 任务指针数组
+
+        explicit ST_DequeBuffer(size_t capacity)
+            : m_capacity(capacity)
+            , m_items(std::make_unique<std::atomic<ST_Task*>[]>(capacity))
+        {
+        }
+
+        ST_Task* Get(int64_t index) const
+        {
+            return m_items[static_cast<size_t>(index) & (m_capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void Put(int64_t index, ST_Task* task)
+        {
+            m_items[static_cast<size_t>(index) & (m_capacity - 1)].store(task, std::memory_order_relaxed);
+        }
+    };
+
+public:
+    static constexpr size_t INITIAL_CAPACITY = 64; ///< 初始容量
+
+    WorkStealingDeque()
+    {
+        m_buffers.push_back(std::make_unique<ST_DequeBuffer>(INITIAL_CAPACITY));
+        m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingDeque()
+    {
+        while (ST_Task* task = Pop())
+        {
+            DestroyPooledTask(task);
+        }
+    }
+
+    // 禁用拷贝构造和赋值
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /// <summary>
+    /// 压入任务（仅拥有者线程调用）
+    /// </summary>
+    void Push(ST_Task* task)
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_acquire);
+        ST_DequeBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+
+        if (bottom - top >= static_cast<int64_t>(buffer->m_capacity))
+        {
+            buffer = Grow(buffer, top, bottom);
+        }
+
+        buffer->Put(bottom, task);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+    }
+
+    /// <summary>
+    /// 弹出最近压入的任务（仅拥有者线程调用）
+    /// </summary>
+    /// <returns>任务指针，队列为空时返回nullptr</returns>
+    ST_Task* Pop()
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        ST_DequeBuffer* buffer = m_buffer.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        ST_Task* task = buffer->Get(bottom);
+        if (top == bottom)
+        {
+            // 只剩最后一个任务，与窃取者竞争
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                task = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    /// <summary>
+    /// 窃取最早压入的任务（任意线程调用）
+    /// </summary>
+    /// <returns>任务指针，队列为空或竞争失败时返回nullptr</returns>
+    ST_Task* Steal()
+    {
+        int64_t top = m_top.load(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_seq_cst);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        ST_DequeBuffer* buffer = m_buffer.load(std::memory_order_acquire);
+        ST_Task* task = buffer->Get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return task;
+    }
+
+    /// <summary>
+    /// 获取队列大小（近似值）
+    /// </summary>
+    size_t Size() const
+    {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+private:
+    /// <summary>
+    /// 扩容缓冲区，旧缓冲区保留到析构，避免窃取者访问已释放内存
+    /// </summary>
+    ST_DequeBuffer* Grow(ST_DequeBuffer* oldBuffer, int64_t top, int64_t bottom)
+    {
+        auto newBuffer = std::make_unique<ST_DequeBuffer>(oldBuffer->m_capacity * 2);
+        for (int64_t i = top; i < bottom; ++i)
+        {
+            newBuffer->Put(i, oldBuffer->Get(i));
+        }
+
+        ST_DequeBuffer* result = newBuffer.get();
+        m_buffers.push_back(std::move(newBuffer));
+        m_buffer.store(result, std::memory_order_release);
+        return result;
+    }
+
+private:
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<int64_t> m_top{0};    ///< 窃取端位置
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom{0}; ///< 拥有者端位置
+    std::atomic<ST_DequeBuffer*> m_buffer{nullptr};                        ///< 当前缓冲区
+    std::vector<std::unique_ptr<ST_DequeBuffer>> m_buffers;                ///< 所有缓冲区（仅拥有者修改）
+};
+
+/// <summary>
+/// 无界多生产者单消费者任务队列（Vyukov侵入式队列）
+/// 生产者只做一次原子交换，没有CAS重试；节点从任务内存块池分配。
+/// 生产者交换队尾后、链接前的短暂窗口内，消费者可能看不到该任务，try_pop暂时返回false
+/// </summary>
+class MpscTaskQueue {
+private:
+    /// <summary>
+    /// 队列节点
+    /// </summary>
+    struct ST_Node
+    {
+        TaskFunction m_func;                    ///< 任务函数
+        std::atomic<ST_Node*> m_next{nullptr};  ///< 下一个节点
+    };
+
+public:
+    MpscTaskQueue()
+        : m_tail(&m_stub)
+        , m_head(&m_stub)
+    {
+    }
+
+    ~MpscTaskQueue()
+    {
+        // 未执行的任务直接销毁，Submit系列的任务包装会以TaskCancelledException完成对应future
+        while (ST_Node* node = Pop())
+        {
+            DestroyNode(node);
+        }
+    }
+
+    // 禁用拷贝构造和赋值
+    MpscTaskQueue(const MpscTaskQueue&) = delete;
+    MpscTaskQueue& operator=(const MpscTaskQueue&) = delete;
+
+    /// <summary>
+    /// 将任务推入队列，可被任意线程并发调用
+    /// </summary>
+    void push(TaskFunction&& func) {
+        void* block = TaskBlockPool::Allocate(sizeof(ST_Node));
+        ST_Node* node = ::new (block) ST_Node();
+        node->m_func = std::move(func);
+        Push(node);
+    }
+
+    /// <summary>
+    /// 尝试从队列中取出任务，只能由消费者线程调用
+    /// </summary>
+    bool try_pop(TaskFunction& func) {
+        ST_Node* node = Pop();
+        if (node == nullptr)
+        {
+            return false;
+        }
+        func = std::move(node->m_func);
+        DestroyNode(node);
+        return true;
+    }
+
+private:
+    /// <summary>
+    /// 链接节点到队尾
+    /// </summary>
+    void Push(ST_Node* node)
+    {
+        node->m_next.store(nullptr, std::memory_order_relaxed);
+        ST_Node* previous = m_tail.exchange(node, std::memory_order_acq_rel);
+        previous->m_next.store(node, std::memory_order_release);
+    }
+
+    /// <summary>
+    /// 取出队首节点，只由消费者调用
+    /// </summary>
+    ST_Node* Pop()
+    {
+        ST_Node* head = m_head;
+        ST_Node* next = head->m_next.load(std::memory_order_acquire);
+        if (head == &m_stub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+            m_head = next;
+            head = next;
+            next = next->m_next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr)
+        {
+            m_head = next;
+            return head;
+        }
+
+        if (head != m_tail.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        // 只剩最后一个节点：放回哨兵后才能取出它
+        Push(&m_stub);
+        next = head->m_next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            m_head = next;
+            return head;
+        }
+        return nullptr;
+    }
+
+    /// <summary>
+    /// 销毁节点
+    /// </summary>
+    static void DestroyNode(ST_Node* node) noexcept
+    {
+        node->~ST_Node();
+        TaskBlockPool::Deallocate(node, sizeof(ST_Node));
+    }
+
+private:
+    ST_Node m_stub;                                                         ///< 哨兵节点
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<ST_Node*> m_tail;      ///< 队尾，生产者交换（独占缓存行）
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) ST_Node* m_head;                   ///< 队首，只由消费者访问（独占缓存行）
+};
+
+/// <summary>
+/// 工作线程槽位，保存每个工作线程的本地状态
+/// </summary>
+struct alignas(THREAD_POOL_CACHE_LINE_SIZE) ST_WorkerSlot
+{
+    WorkStealingDeque m_localTasks;     ///< 本地任务队列，按需增长，不计入m_maxQueueSize
+    std::atomic<bool> m_inUse{false};   ///< 槽位是否被工作线程占用
+    std::mutex m_parkMutex;             ///< 休眠互斥锁
+    std::condition_variable m_parkCondition; ///< 休眠条件变量，每个工作线程独立，实现定向唤醒
+    bool m_wakeSignal{false};           ///< 唤醒信号，受m_parkMutex保护
+    size_t m_spinLimit{0};              ///< 自适应自旋次数（仅拥有者线程访问）
+    std::atomic<ST_ThreadStats*> m_stats{nullptr}; ///< 运行统计，首次占用槽位时创建，之后随槽位复用
+    std::atomic<TaskTraceRing*> m_traceRing{nullptr}; ///< 执行轨迹缓冲，开启跟踪后由拥有者线程首次记录时创建
+    size_t m_node{0};                   ///< 所属CPU分区（NUMA节点），由槽位下标决定，构造线程池时设置后不再改变
+    std::atomic<PriorityTaskQueue*> m_inbox{nullptr}; ///< 定向提交到该槽位的任务，首次定向提交时创建，之后随槽位复用；不计入m_maxQueueSize
+
+    ST_WorkerSlot() = default;
+    ST_WorkerSlot(const ST_WorkerSlot&) = delete;
+    ST_WorkerSlot& operator=(const ST_WorkerSlot&) = delete;
+
+    ~ST_WorkerSlot()
+    {
+        delete m_stats.load(std::memory_order_relaxed);
+        delete m_traceRing.load(std::memory_order_relaxed);
+        delete m_inbox.load(std::memory_order_relaxed);
+    }
+};
+
+/// <summary>
+/// 非工作线程（提交者、协助执行者、定时线程）在一个线程池中的本地状态，每个线程独占一份，按缓存行对齐
+/// 线程退出时释放给后来的线程复用，计数继续累加，汇总结果不受影响
+/// </summary>
+struct alignas(THREAD_POOL_CACHE_LINE_SIZE) ST_ExternalThreadState
+{
+    ST_ThreadStats m_stats;                           ///< 运行统计
+    std::atomic<TaskTraceRing*> m_traceRing{nullptr}; ///< 执行轨迹缓冲，开启跟踪后由拥有者线程首次记录时创建，随实例复用
+    std::atomic<bool> m_inUse{true};                  ///< 是否被某个线程占用，占用期间只有该线程写入
+    ST_ExternalThreadState* m_next{nullptr};          ///< 登记链表中的下一个实例，发布后不再改变
+    size_t m_index{0};                                ///< 登记顺序，用作轨迹中的线程编号
+
+    ST_ExternalThreadState() = default;
+    ST_ExternalThreadState(const ST_ExternalThreadState&) = delete;
+    ST_ExternalThreadState& operator=(const ST_ExternalThreadState&) = delete;
+
+    ~ST_ExternalThreadState()
+    {
+        delete m_traceRing.load(std::memory_order_relaxed);
+    }
+};
+
+/// <summary>
+/// 非工作线程本地状态的登记表，只增不删，由线程池与各线程的缓存共同持有，
+/// 线程退出时即使线程池正在析构也能安全地释放自己的实例
+/// </summary>
+struct ST_ExternalThreadRegistry
+{
+    std::atomic<ST_ExternalThreadState*> m_head{nullptr}; ///< 登记链表头，新实例插入表头
+    std::atomic<size_t> m_count{0};                       ///< 已登记的实例数
+    ST_ExternalThreadState m_shared;                      ///< 线程本地缓存已销毁（线程退出过程中）时使用的共享实例，多个线程写入，不记录轨迹
+
+    ST_ExternalThreadRegistry() = default;
+    ST_ExternalThreadRegistry(const ST_ExternalThreadRegistry&) = delete;
+    ST_ExternalThreadRegistry& operator=(const ST_ExternalThreadRegistry&) = delete;
+
+    ~ST_ExternalThreadRegistry()
+    {
+        ST_ExternalThreadState* state = m_head.load(std::memory_order_relaxed);
+        while (state != nullptr)
+        {
+            ST_ExternalThreadState* next = state->m_next;
+            delete state;
+            state = next;
+        }
+    }
+
+    /// <summary>
+    /// 占用一个空闲实例，没有空闲实例时创建并登记
+    /// </summary>
+    ST_ExternalThreadState* Acquire()
+    {
+        for (ST_ExternalThreadState* state = m_head.load(std::memory_order_acquire); state != nullptr; state = state->m_next)
+        {
+            bool expected = false;
+            if (!state->m_inUse.load(std::memory_order_relaxed) && state->m_inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                return state;
+            }
+        }
+
+        auto* state = new ST_ExternalThreadState();
+        state->m_index = m_count.fetch_add(1, std::memory_order_relaxed);
+        ST_ExternalThreadState* head = m_head.load(std::memory_order_relaxed);
+        do
+        {
+            state->m_next = head;
+        } while (!m_head.compare_exchange_weak(head, state));
+        return state;
+    }
+
+    /// <summary>
+    /// 遍历所有已登记的实例（不含共享实例）
+    /// </summary>
+    template <typename Visitor>
+    void ForEach(Visitor&& visitor) const
+    {
+        for (ST_ExternalThreadState* state = m_head.load(std::memory_order_acquire); state != nullptr; state = state->m_next)
+        {
+            visitor(*state);
+        }
+    }
+};
+
+/// <summary>
+/// 并行算法的共享状态，保存在调用线程栈上，调用线程等待m_pending归零后才返回
+/// </summary>
+struct ST_ParallelContext
+{
+    std::atomic<size_t> m_pending{0};   ///< 已入队但未结束的子区间任务数
+    std::atomic<bool> m_failed{false};  ///< 是否已有子区间失败，失败后剩余子区间直接跳过
+    std::exception_ptr m_exception;     ///< 第一个失败子区间的异常，只由设置m_failed的线程写入
+
+    /// <summary>
+    /// 记录失败，只保留第一个异常
+    /// </summary>
+    /// <param name="exception">异常</param>
+    void Fail(std::exception_ptr exception)
+    {
+        bool expected = false;
+        if (m_failed.compare_exchange_strong(expected, true))
+        {
+            m_exception = exception;
+        }
+    }
+};
+
+/// <summary>
+/// 专用线程状态枚举
+/// </summary>
+enum class EM_DedicatedThreadState
+{
+    Running,    ///< 运行中
+    Stopped,    ///< 已停止
+    Error       ///< 发生错误
+};
+
+/// <summary>
+/// 专用线程信息结构体
+/// 专用线程是长期运行的事件循环：先执行一次初始化函数，然后批量执行邮箱中的任务，邮箱为空时短暂自旋后休眠，直到被停止。
+/// 邮箱是独立的多生产者单消费者队列，不与线程池的任务队列共享，适合承载音频采集等对延迟敏感的循环
+/// </summary>
+struct ST_DedicatedThreadInfo
+{
+    std::thread m_thread;                    ///< 线程对象
+    std::atomic<EM_DedicatedThreadState> m_state{EM_DedicatedThreadState::Running}; ///< 线程状态
+    std::string m_name;                      ///< 线程名称
+    std::function<void()> m_task;            ///< 初始化函数，进入事件循环前执行一次，可为空
+    int m_cpuCore{-1};                       ///< 绑定的CPU核心，-1表示不绑定
+    MpscTaskQueue m_mailbox;                 ///< 邮箱
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<size_t> m_pending{0}; ///< 邮箱中尚未执行的任务数
+    std::atomic<bool> m_waiting{false};      ///< 事件循环是否即将休眠，为false时投递任务无需加锁唤醒
+    std::atomic<bool> m_stop{false};         ///< 停止标志，置位后不再接受新任务
+    std::atomic<uint64_t> m_executedCount{0}; ///< 已执行的邮箱任务数
+    std::mutex m_mutex;                      ///< 休眠互斥锁
+    std::condition_variable m_condition;     ///< 休眠条件变量
+
+    ST_DedicatedThreadInfo() = default;
+
+    // 禁用拷贝构造和赋值
+    ST_DedicatedThreadInfo(const ST_DedicatedThreadInfo&) = delete;
+    ST_DedicatedThreadInfo& operator=(const ST_DedicatedThreadInfo&) = delete;
+};
+
+/// <summary>
+/// 专用线程状态快照
+/// </summary>
+struct ST_DedicatedThreadStatus
+{
+    size_t m_threadId{0};                    ///< 线程ID
+    std::string m_name;                      ///< 线程名称
+    EM_DedicatedThreadState m_state{EM_DedicatedThreadState::Stopped}; ///< 线程状态
+    int m_cpuCore{-1};                       ///< 绑定的CPU核心，-1表示未绑定
+    size_t m_pendingCount{0};                ///< 邮箱中尚未执行的任务数
+    uint64_t m_executedCount{0};             ///< 已执行的邮箱任务数
+};
+
+class ThreadPool;
+class TimerWheel;
+
+/// <summary>
+/// 阻塞标记：工作线程即将执行可能长时间阻塞的操作（磁盘、管道、网络等待）前在栈上创建。
+/// 线程池把该线程视为暂时不可运行，队列中有任务且没有空闲线程时临时增加一个补偿线程（不超过m_maxBlockingThreads），
+/// 标记析构后多出的线程在空闲或执行完当前任务后退出。同一线程嵌套创建时只有最外层生效，在非工作线程中创建不做任何事
+/// </summary>
+class SDK_API ScopedBlocking
+{
+public:
+    ScopedBlocking();
+    ~ScopedBlocking();
+
+    // 禁用拷贝构造和赋值
+    ScopedBlocking(const ScopedBlocking&) = delete;
+    ScopedBlocking& operator=(const ScopedBlocking&) = delete;
+
+private:
+    ThreadPool* m_pool; ///< 当前工作线程所属的线程池，未生效时为空
+};
+
+/// <summary>
+/// 协助等待点：TaskGroup、Pipeline等在条件成立前阻塞调用线程的同步对象内嵌一个。
+/// 等待期间先协助执行线程池任务；非工作线程在条件变量上休眠，工作线程登记到线程池的休眠列表中休眠，
+/// 有新任务提交（与空闲工作线程一样被唤醒）或NotifyAll时醒来继续协助，不做定时轮询。
+/// 使条件成立的一方在持有GetMutex()时修改条件并调用NotifyAll，Wait返回后不会再有通知方访问等待点
+/// </summary>
+class SDK_API HelpingWaiter
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="pool">协助执行任务的线程池</param>
+    explicit HelpingWaiter(ThreadPool& pool);
+
+    // 禁用拷贝构造和赋值
+    HelpingWaiter(const HelpingWaiter&) = delete;
+    HelpingWaiter& operator=(const HelpingWaiter&) = delete;
+
+    /// <summary>
+    /// 等待条件成立，等待期间协助执行线程池任务
+    /// </summary>
+    /// <param name="predicate">条件，可在不持有锁时调用</param>
+    template <typename Predicate>
+    void Wait(Predicate predicate);
+
+    /// <summary>
+    /// 唤醒所有等待者，调用方需持有GetMutex()
+    /// </summary>
+    void NotifyAll();
+
+    /// <summary>
+    /// 获取等待互斥锁
+    /// </summary>
+    std::mutex& GetMutex() { return m_mutex; }
+
+private:
+    ThreadPool& m_pool;                         ///< 线程池
+    std::mutex m_mutex;                         ///< 等待互斥锁
+    std::condition_variable m_condition;        ///< 非工作线程的等待条件变量
+    std::vector<ST_WorkerSlot*> m_parkedSlots;  ///< 在休眠列表中等待的工作线程槽位（受m_mutex保护）
+    size_t m_waiters{0};                        ///< 等待中的线程数（受m_mutex保护）
+};
+
+using TimerId = uint64_t; ///< 定时器编号，由SubmitAfter/SubmitAt/SubmitEvery返回，用于CancelTimer
+
+/// <summary>
+/// 恢复协程的任务，未执行就被销毁（线程池停止、过载策略丢弃、定时器被丢弃）时记录取消并恢复协程，
+/// 协程在co_await处收到TaskCancelledException，不会永远挂起或泄漏协程帧
+/// </summary>
+struct ST_ResumeTask
+{
+    std::coroutine_handle<> m_handle; ///< 待恢复的协程，执行或移走后为空
+    bool* m_cancelled;                ///< 等待体中的取消标志
+
+    ST_ResumeTask(std::coroutine_handle<> handle, bool* cancelled) noexcept
+        : m_handle(handle), m_cancelled(cancelled)
+    {
+    }
+
+    ST_ResumeTask(ST_ResumeTask&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr)), m_cancelled(other.m_cancelled)
+    {
+    }
+
+    // 禁用拷贝构造和赋值
+    ST_ResumeTask(const ST_ResumeTask&) = delete;
+    ST_ResumeTask& operator=(const ST_ResumeTask&) = delete;
+
+    ~ST_ResumeTask()
+    {
+        if (std::coroutine_handle<> handle = std::exchange(m_handle, nullptr))
+        {
+            *m_cancelled = true;
+            handle.resume();
+        }
+    }
+
+    void operator()()
+    {
+        std::exchange(m_handle, nullptr).resume();
+    }
+};
+
+/// <summary>
+/// 协程调度等待体，co_await之后协程在线程池的工作线程上继续执行
+/// </summary>
+struct ST_ScheduleAwaitable
+{
+    ThreadPool* m_pool;           ///< 目标线程池
+    EM_TaskPriority m_priority;   ///< 恢复任务的优先级
+    bool m_cancelled = false;     ///< 恢复任务未执行就被丢弃
+
+    bool await_ready() const noexcept { return false; }
+
+    /// <summary>
+    /// 把协程的恢复投递到线程池
+    /// </summary>
+    void await_suspend(std::coroutine_handle<> handle);
+
+    /// <summary>
+    /// 线程池已停止或恢复任务被过载策略丢弃时抛出TaskCancelledException
+    /// </summary>
+    void await_resume() const
+    {
+        if (m_cancelled)
+        {
+            throw TaskCancelledException();
+        }
+    }
+};
+
+/// <summary>
+/// 协程延迟等待体，到达指定时间后协程在线程池的工作线程上继续执行，等待期间不占用任何线程
+/// </summary>
+struct ST_DelayAwaitable
+{
+    ThreadPool* m_pool;                              ///< 目标线程池
+    std::chrono::steady_clock::time_point m_when;    ///< 恢复时间
+    EM_TaskPriority m_priority;                      ///< 恢复任务的优先级
+    bool m_cancelled = false;                        ///< 定时器或恢复任务未执行就被丢弃
+
+    bool await_ready() const noexcept { return false; }
+
+    /// <summary>
+    /// 注册定时器恢复协程
+    /// </summary>
+    void await_suspend(std::coroutine_handle<> handle);
+
+    /// <summary>
+    /// 线程池已停止或在到期前停止时抛出TaskCancelledException
+    /// </summary>
+    void await_resume() const
+    {
+        if (m_cancelled)
+        {
+            throw TaskCancelledException();
+        }
+    }
+};
+
+/// <summary>
+/// 线程池类，提供基于优先级的任务调度功能
+/// </summary>
+class SDK_API ThreadPool
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="config">线程池配置</param>
+    explicit ThreadPool(const ST_ThreadPoolConfig& config = ST_ThreadPoolConfig());
+
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~ThreadPool();
+
+    /// <summary>
+    /// 提交任务到线程池
+    /// 任务未执行就被丢弃（过载拒绝、线程池停止）时，future以TaskCancelledException完成
+    /// </summary>
+    /// <param name="task">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>future对象，用于获取任务结果</returns>
+    template <typename F>
+    auto Submit(F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal) 
+        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
+    {
+        return Submit(std::forward<F>(f), CancellationToken(), std::chrono::steady_clock::time_point::max(), priority);
+    }
+
+    /// <summary>
+    /// 提交可取消的任务，出队时令牌已取消则跳过执行
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="token">取消令牌</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>future对象，任务被取消时以TaskCancelledException完成</returns>
+    template <typename F>
+    auto Submit(F&& f, const CancellationToken& token, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
+    {
+        return Submit(std::forward<F>(f), token, std::chrono::steady_clock::time_point::max(), priority);
+    }
+
+    /// <summary>
+    /// 提交带截止时间的任务，出队时已超过截止时间则跳过执行
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="deadline">截止时间</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>future对象，任务超时未执行时以TaskCancelledException完成</returns>
+    template <typename F>
+    auto Submit(F&& f, std::chrono::steady_clock::time_point deadline, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
+    {
+        return Submit(std::forward<F>(f), CancellationToken(), deadline, priority);
+    }
+
+    /// <summary>
+    /// 提交可取消且带截止时间的任务；提交时已取消或已超时的任务不入队
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="token">取消令牌</param>
+    /// <param name="deadline">截止时间</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>future对象，任务未执行时以TaskCancelledException完成</returns>
+    template <typename F>
+    auto Submit(F&& f, const CancellationToken& token, std::chrono::steady_clock::time_point deadline, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
+    {
+        using return_type = decltype(std::declval<std::decay_t<F>>()());
+
+        // 包装对象仅可移动，直接保存在TaskFunction中；从未被调用就销毁时由其析构函数完成future
+        CancellableCall<return_type, std::decay_t<F>> call(std::forward<F>(f));
+        std::future<return_type> res = call.GetFuture();
+
+        ST_Task taskWrapper;
+        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+        taskWrapper.m_token = token;
+        taskWrapper.m_deadline = deadline;
+        if (taskWrapper.IsCancelled(taskWrapper.m_submitTime))
+        {
+            return res;
+        }
+        taskWrapper.m_func = std::move(call);
+        taskWrapper.m_priority = priority;
+
+        ThrowOnSubmitFailure(SubmitTask(taskWrapper));
+        return res;
+    }
+
+    /// <summary>
+    /// 提交会阻塞的任务（文件、管道、同步网络调用等），任务在ScopedBlocking范围内执行，
+    /// 阻塞期间线程池补偿线程，计算密集型任务不会因此排队
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>future对象，用于获取任务结果</returns>
+    template <typename F>
+    auto SubmitBlocking(F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
+    {
+        return Submit([func = std::decay_t<F>(std::forward<F>(f))]() mutable
+        {
+            ScopedBlocking blocking;
+            return func();
+        }, priority);
+    }
+
+    /// <summary>
+    /// 提交任务到指定工作线程，任务只由该线程执行，访问的数据留在同一核心的缓存中；
+    /// 指定槽位当前没有工作线程时按普通任务入队
+    /// </summary>
+    /// <param name="workerIndex">工作线程下标，与GetCurrentWorkerIndex()的返回值一致</param>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>future对象，用于获取任务结果</returns>
+    template <typename F>
+    auto SubmitTo(size_t workerIndex, F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
+    {
+        using return_type = decltype(std::declval<std::decay_t<F>>()());
+
+        if (workerIndex >= MAX_WORKER_SLOTS)
+        {
+            throw std::out_of_range("Worker index out of range");
+        }
+
+        CancellableCall<return_type, std::decay_t<F>> call(std::forward<F>(f));
+        std::future<return_type> res = call.GetFuture();
+
+        ST_Task taskWrapper;
+        taskWrapper.m_func = std::move(call);
+        taskWrapper.m_priority = priority;
+        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+
+        ThrowOnSubmitFailure(SubmitTask(taskWrapper, workerIndex));
+        return res;
+    }
+
+    /// <summary>
+    /// 按键提交任务，相同键的任务总是交给同一个常驻工作线程（下标小于最小线程数）执行，
+    /// 适合按流、连接等划分的任务重复访问同一份较大的状态
+    /// </summary>
+    /// <param name="hintKey">局部性提示键，需可用std::hash计算哈希</param>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>future对象，用于获取任务结果</returns>
+    template <typename Key, typename F>
+    auto SubmitNear(const Key& hintKey, F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        -> std::future<decltype(std::declval<std::decay_t<F>>()())>
+    {
+        return SubmitTo(AffinityWorkerIndex(std::hash<Key>()(hintKey)), std::forward<F>(f), priority);
+    }
+
+    /// <summary>
+    /// 提交无需返回值的任务到线程池，不创建future
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    template <typename F>
+    void Post(F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        ST_Task taskWrapper;
+        taskWrapper.m_func = std::forward<F>(f);
+        taskWrapper.m_priority = priority;
+        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+
+        ThrowOnSubmitFailure(SubmitTask(taskWrapper));
+    }
+
+    /// <summary>
+    /// 提交可取消的无需返回值的任务，出队时令牌已取消则跳过执行
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="token">取消令牌</param>
+    /// <param name="priority">任务优先级</param>
+    template <typename F>
+    void Post(F&& f, const CancellationToken& token, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        if (token.IsCancellationRequested())
+        {
+            return;
+        }
+
+        ST_Task taskWrapper;
+        taskWrapper.m_func = std::forward<F>(f);
+        taskWrapper.m_priority = priority;
+        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+        taskWrapper.m_token = token;
+
+        ThrowOnSubmitFailure(SubmitTask(taskWrapper));
+    }
+
+    /// <summary>
+    /// 批量投递同一优先级的无需返回值的任务，不创建future
+    /// 整批任务用一次原子操作在目标队列中预留槽位并一次唤醒所需数量的线程，适合一次扇出成千上万个小任务；
+    /// 队列剩余空间不足时，放不下的任务逐个按过载策略提交。任务函数从funcs中移出
+    /// 只有整批任务都未被接受时才按过载策略抛出异常；已有任务入队后不再抛出，其余被丢弃的任务通过返回值体现
+    /// </summary>
+    /// <param name="funcs">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>被接受（入队或在提交线程上执行）的任务数</returns>
+    template <typename F>
+    size_t PostBulk(std::span<F> funcs, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        std::vector<ST_Task> tasks(funcs.size());
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < funcs.size(); ++i)
+        {
+            tasks[i].m_func = std::move(funcs[i]);
+            tasks[i].m_priority = priority;
+            tasks[i].m_submitTime = now;
+        }
+
+        size_t accepted = 0;
+        EM_SubmitStatus status = SubmitTasks(tasks, accepted);
+        if (accepted == 0)
+        {
+            ThrowOnSubmitFailure(status);
+        }
+        return accepted;
+    }
+
+    /// <summary>
+    /// 批量提交同一优先级的任务，入队方式同PostBulk
+    /// 只有整批任务都未被接受时才按过载策略抛出异常；已有任务入队后总是返回全部future，
+    /// 未能提交的任务（线程池已停止或被过载策略丢弃）对应的future报告TaskCancelledException
+    /// </summary>
+    /// <param name="funcs">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>与funcs一一对应的future对象</returns>
+    template <typename F>
+    auto SubmitBulk(std::span<F> funcs, EM_TaskPriority priority = EM_TaskPriority::Normal)
+        -> std::vector<std::future<decltype(std::declval<std::decay_t<F>>()())>>
+    {
+        using return_type = decltype(std::declval<std::decay_t<F>>()());
+
+        std::vector<std::future<return_type>> results;
+        results.reserve(funcs.size());
+        std::vector<ST_Task> tasks(funcs.size());
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < funcs.size(); ++i)
+        {
+            CancellableCall<return_type, std::decay_t<F>> call(std::move(funcs[i]));
+            results.push_back(call.GetFuture());
+            tasks[i].m_func = std::move(call);
+            tasks[i].m_priority = priority;
+            tasks[i].m_submitTime = now;
+        }
+
+        size_t accepted = 0;
+        EM_SubmitStatus status = SubmitTasks(tasks, accepted);
+        if (accepted == 0)
+        {
+            ThrowOnSubmitFailure(status);
+        }
+        return results;
+    }
+
+    /// <summary>
+    /// 按过载策略提交无需返回值的任务，通过返回值报告结果，不抛出异常（Throw策略按Reject处理）
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>提交结果</returns>
+    template <typename F>
+    EM_SubmitStatus TryPost(F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        ST_Task taskWrapper;
+        taskWrapper.m_func = std::forward<F>(f);
+        taskWrapper.m_priority = priority;
+        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+
+        return SubmitTask(taskWrapper);
+    }
+
+    /// <summary>
+    /// 按过载策略提交任务，通过返回值报告结果，不抛出异常（Throw策略按Reject处理）
+    /// 任务被丢弃时result仍然有效，其get()抛出TaskCancelledException
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="result">输出future对象</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>提交结果</returns>
+    template <typename F>
+    EM_SubmitStatus TrySubmit(F&& f, std::future<decltype(std::declval<std::decay_t<F>>()())>& result, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        using return_type = decltype(std::declval<std::decay_t<F>>()());
+
+        CancellableCall<return_type, std::decay_t<F>> call(std::forward<F>(f));
+        result = call.GetFuture();
+
+        ST_Task taskWrapper;
+        taskWrapper.m_func = std::move(call);
+        taskWrapper.m_priority = priority;
+        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+
+        return SubmitTask(taskWrapper);
+    }
+
+    /// <summary>
+    /// 投递任务，队列已满或线程池已停止时不论过载策略都在当前线程执行，任务异常传播给调用者；
+    /// 入队的任务不会被DropOldestLowest策略挤出，只在线程池停止时随队列一起丢弃。用于协程恢复、续接等不能丢弃的内部任务
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    template <typename F>
+    void PostOrRun(F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        ST_Task taskWrapper;
+        taskWrapper.m_func = std::forward<F>(f);
+        taskWrapper.m_priority = priority;
+        taskWrapper.m_submitTime = std::chrono::steady_clock::now();
+        taskWrapper.m_evictable = false;
+
+        if (m_stop.load(std::memory_order_acquire) || !PushTask(std::move(taskWrapper)))
+        {
+            taskWrapper.m_func();
+        }
+    }
+
+    /// <summary>
+    /// 提交任务到线程池，返回支持Then续接的TaskFuture（定义见TaskFuture.h）
+    /// </summary>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>TaskFuture对象</returns>
+    template <typename F>
+    auto SubmitAsync(F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal) -> TaskFuture<std::invoke_result_t<std::decay_t<F>&>>;
+
+    /// <summary>
+    /// 并行执行 fn(i)，i 取 [begin, end)
+    /// 区间按粒度递归二分，一半入队供其他线程执行，另一半继续在当前线程拆分；调用线程等待期间协助执行队列中的任务
+    /// </summary>
+    /// <param name="begin">起始下标</param>
+    /// <param name="end">结束下标（不含）</param>
+    /// <param name="grain">每个子区间的最小元素数，为0时按线程数自动选择</param>
+    /// <param name="fn">元素处理函数</param>
+    template <typename Index, typename F>
+    void ParallelFor(Index begin, Index end, size_t grain, F&& fn)
+    {
+        static_assert(std::is_integral_v<Index>, "ParallelFor requires an integral index type");
+        if (end <= begin)
+        {
+            return;
+        }
+
+        auto body = [begin, &fn](size_t chunkBegin, size_t chunkEnd)
+        {
+            for (size_t i = chunkBegin; i < chunkEnd; ++i)
+            {
+                fn(static_cast<Index>(begin + static_cast<Index>(i)));
+            }
+        };
+        RunParallelRange(static_cast<size_t>(end - begin), grain, body);
+    }
+
+    /// <summary>
+    /// 并行执行 fn(i)，按线程数自动选择粒度
+    /// </summary>
+    /// <param name="begin">起始下标</param>
+    /// <param name="end">结束下标（不含）</param>
+    /// <param name="fn">元素处理函数</param>
+    template <typename Index, typename F>
+    void ParallelFor(Index begin, Index end, F&& fn)
+    {
+        ParallelFor(begin, end, 0, std::forward<F>(fn));
+    }
+
+    /// <summary>
+    /// 并行归约，结果等于按下标顺序计算 reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))..., map(end - 1))
+    /// 每个子区间独立归约后再按子区间顺序合并，reduce需满足结合律，浮点结果在粒度不变时可重复
+    /// </summary>
+    /// <param name="begin">起始下标</param>
+    /// <param name="end">结束下标（不含）</param>
+    /// <param name="grain">每个子区间的最小元素数，为0时按线程数自动选择</param>
+    /// <param name="identity">归约单位元</param>
+    /// <param name="map">元素映射函数</param>
+    /// <param name="reduce">归约函数</param>
+    /// <returns>归约结果</returns>
+    template <typename Index, typename T, typename MapFunc, typename ReduceFunc>
+    T ParallelReduce(Index begin, Index end, size_t grain, T identity, MapFunc&& map, ReduceFunc&& reduce)
+    {
+        static_assert(std::is_integral_v<Index>, "ParallelReduce requires an integral index type");
+        if (end <= begin)
+        {
+            return identity;
+        }
+
+        size_t count = static_cast<size_t>(end - begin);
+        if (grain == 0)
+        {
+            grain = AutoGrainSize(count);
+        }
+
+        // 子区间边界固定为粒度的整数倍，每个子区间的部分结果写入各自的位置
+        std::vector<T> partials((count + grain - 1) / grain, identity);
+        auto body = [begin, grain, &partials, &map, &reduce](size_t chunkBegin, size_t chunkEnd)
+        {
+            T accumulator = partials[chunkBegin / grain];
+            for (size_t i = chunkBegin; i < chunkEnd; ++i)
+            {
+                accumulator = reduce(std::move(accumulator), map(static_cast<Index>(begin + static_cast<Index>(i))));
+            }
+            partials[chunkBegin / grain] = std::move(accumulator);
+        };
+        RunParallelRange(count, grain, body);
+
+        T result = std::move(identity);
+        for (T& partial : partials)
+        {
+            result = reduce(std::move(result), std::move(partial));
+        }
+        return result;
+    }
+
+    /// <summary>
+    /// 并行变换，out[i] = fn(first[i])
+    /// </summary>
+    /// <param name="first">输入起始迭代器（随机访问）</param>
+    /// <param name="last">输入结束迭代器</param>
+    /// <param name="out">输出起始迭代器（随机访问）</param>
+    /// <param name="fn">变换函数</param>
+    /// <param name="grain">每个子区间的最小元素数，为0时按线程数自动选择</param>
+    /// <returns>输出结束迭代器</returns>
+    template <typename InputIt, typename OutputIt, typename F>
+    OutputIt ParallelTransform(InputIt first, InputIt last, OutputIt out, F&& fn, size_t grain = 0)
+    {
+        auto count = std::distance(first, last);
+        if (count <= 0)
+        {
+            return out;
+        }
+
+        auto body = [first, out, &fn](size_t chunkBegin, size_t chunkEnd)
+        {
+            InputIt input = first + static_cast<std::ptrdiff_t>(chunkBegin);
+            OutputIt output = out + static_cast<std::ptrdiff_t>(chunkBegin);
+            for (size_t i = chunkBegin; i < chunkEnd; ++i, ++input, ++output)
+            {
+                *output = fn(*input);
+            }
+        };
+        RunParallelRange(static_cast<size_t>(count), grain, body);
+        return out + count;
+    }
+
+    /// <summary>
+    /// 并行排序（不稳定），先并行排序各分块，再逐轮并行两两归并
+    /// </summary>
+    /// <param name="first">起始迭代器（随机访问）</param>
+    /// <param name="last">结束迭代器</param>
+    /// <param name="comp">比较函数</param>
+    template <typename RandomIt, typename Compare = std::less<>>
+    void ParallelSort(RandomIt first, RandomIt last, Compare comp = Compare())
+    {
+        size_t count = static_cast<size_t>(std::distance(first, last));
+        size_t chunkCount = 1;
+        while (chunkCount < GetParallelism() * 2)
+        {
+            chunkCount <<= 1;
+        }
+
+        if (count <= SERIAL_SORT_THRESHOLD || chunkCount <= 1)
+        {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+        ParallelFor(size_t(0), chunkCount, 1, [&](size_t chunk)
+        {
+            size_t low = std::min(chunk * chunkSize, count);
+            size_t high = std::min(low + chunkSize, count);
+            std::sort(first + low, first + high, comp);
+        });
+
+        for (size_t width = 1; width < chunkCount; width <<= 1)
+        {
+            ParallelFor(size_t(0), chunkCount / (width * 2), 1, [&](size_t pair)
+            {
+                size_t low = std::min(pair * width * 2 * chunkSize, count);
+                size_t middle = std::min(low + width * chunkSize, count);
+                size_t high = std::min(middle + width * chunkSize, count);
+                if (middle < high)
+                {
+                    std::inplace_merge(first + low, first + middle, first + high, comp);
+                }
+            });
+        }
+    }
+
+    /// <summary>
+    /// 在调用线程上执行一个待执行任务，供等待中的线程协助线程池
+    /// </summary>
+    /// <returns>是否执行了任务</returns>
+    bool RunPendingTask();
+
+    /// <summary>
+    /// 在协程中 co_await pool.Schedule() 把协程切换到线程池的工作线程上执行
+    /// </summary>
+    /// <param name="priority">恢复任务的优先级</param>
+    /// <returns>调度等待体</returns>
+    ST_ScheduleAwaitable Schedule(EM_TaskPriority priority = EM_TaskPriority::Normal) { return ST_ScheduleAwaitable{this, priority}; }
+
+    /// <summary>
+    /// 在协程中 co_await pool.ScheduleAfter(delay) 延迟后在线程池上继续执行
+    /// </summary>
+    /// <param name="delay">延迟时长</param>
+    /// <param name="priority">恢复任务的优先级</param>
+    /// <returns>延迟等待体</returns>
+    template <typename Rep, typename Period>
+    ST_DelayAwaitable ScheduleAfter(std::chrono::duration<Rep, Period> delay, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        return ST_DelayAwaitable{this, std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay), priority};
+    }
+
+    /// <summary>
+    /// 在协程中 co_await pool.ScheduleAt(when) 到达指定时间后在线程池上继续执行
+    /// </summary>
+    /// <param name="when">恢复时间</param>
+    /// <param name="priority">恢复任务的优先级</param>
+    /// <returns>延迟等待体</returns>
+    ST_DelayAwaitable ScheduleAt(std::chrono::steady_clock::time_point when, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        return ST_DelayAwaitable{this, when, priority};
+    }
+
+    /// <summary>
+    /// 延迟提交任务，到期后放入普通任务队列；精度为1毫秒
+    /// </summary>
+    /// <param name="delay">延迟时长</param>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>定时器编号</returns>
+    template <typename Rep, typename Period, typename F>
+    TimerId SubmitAfter(std::chrono::duration<Rep, Period> delay, F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        return SubmitAt(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay), std::forward<F>(f), priority);
+    }
+
+    /// <summary>
+    /// 在指定时间提交任务，到期后放入普通任务队列；时间已过时在下一个tick提交
+    /// </summary>
+    /// <param name="when">到期时间</param>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>定时器编号</returns>
+    template <typename F>
+    TimerId SubmitAt(std::chrono::steady_clock::time_point when, F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        if (m_stop)
+        {
+            throw std::runtime_error("ThreadPool is stopped");
+        }
+        return AddTimer(when, std::chrono::steady_clock::duration::zero(), TaskFunction(std::forward<F>(f)), priority);
+    }
+
+    /// <summary>
+    /// 按固定频率周期提交任务，首次在一个周期后执行；上一次尚未执行完时跳过本次，直到CancelTimer或线程池停止
+    /// </summary>
+    /// <param name="period">周期，至少1毫秒</param>
+    /// <param name="f">任务函数</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>定时器编号</returns>
+    template <typename Rep, typename Period, typename F>
+    TimerId SubmitEvery(std::chrono::duration<Rep, Period> period, F&& f, EM_TaskPriority priority = EM_TaskPriority::Normal)
+    {
+        auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+        if (interval <= std::chrono::steady_clock::duration::zero())
+        {
+            throw std::invalid_argument("period must be positive");
+        }
+        if (m_stop)
+        {
+            throw std::runtime_error("ThreadPool is stopped");
+        }
+        return AddTimer(std::chrono::steady_clock::now() + interval, interval, TaskFunction(std::forward<F>(f)), priority);
+    }
+
+    /// <summary>
+    /// 取消定时器；周期定时器已投递的本次执行不受影响
+    /// </summary>
+    /// <param name="id">定时器编号</param>
+    /// <returns>是否取消成功，一次性定时器已到期时返回false</returns>
+    bool CancelTimer(TimerId id);
+
+    /// <summary>
+    /// 获取当前线程数
+    /// </summary>
+    /// <returns>当前线程数</returns>
+    size_t GetCurrentThreadCount() const { return m_totalThreads.load(); }
+
+    /// <summary>
+    /// 获取当前任务数
+    /// </summary>
+    /// <returns>当前任务数</returns>
+    size_t GetTaskCount() { return GetPendingTaskCount(); }
+
+    /// <summary>
+    /// 获取当前线程的工作线程下标，可传给SubmitTo把后续任务留在本线程
+    /// </summary>
+    /// <returns>工作线程下标，当前线程不是本线程池的工作线程时返回SIZE_MAX</returns>
+    size_t GetCurrentWorkerIndex() const;
+
+    /// <summary>
+    /// 获取工作线程的CPU分区数，未配置CPU集合且未启用NUMA划分时为0
+    /// </summary>
+    /// <returns>分区数</returns>
+    size_t GetNodeCount() const { return m_nodeCpus.size(); }
+
+    /// <summary>
+    /// 汇总各工作线程的计数与直方图，生成统计快照；开销与线程数成正比，适合定期采集而非每个任务调用
+    /// </summary>
+    /// <returns>统计快照</returns>
+    ST_ThreadPoolStats GetStats() const;
+
+    /// <summary>
+    /// 清空所有统计（与并发任务同时进行时结果为近似值）
+    /// </summary>
+    void ResetStats();
+
+    /// <summary>
+    /// 开启执行轨迹记录：每个线程把任务的入队、开始、结束时间写入自己的环形缓冲，写满后覆盖最早的记录
+    /// 缓冲在各线程首次记录时创建，之后再次开启时沿用已有缓冲的容量
+    /// </summary>
+    /// <param name="eventsPerThread">每个线程保留的记录数</param>
+    void EnableTracing(size_t eventsPerThread = DEFAULT_TRACE_EVENTS);
+
+    /// <summary>
+    /// 停止执行轨迹记录，已记录的内容保留，仍可导出
+    /// </summary>
+    void DisableTracing();
+
+    /// <summary>
+    /// 是否正在记录执行轨迹
+    /// </summary>
+    bool IsTracing() const { return m_tracing.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 导出各线程缓冲中的执行轨迹为Chrome trace-event JSON，可在chrome://tracing或Perfetto中打开；可与任务执行并发调用
+    /// </summary>
+    /// <param name="out">输出流</param>
+    void WriteChromeTrace(std::ostream& out) const;
+
+    /// <summary>
+    /// 获取指定优先级的排队等待统计
+    /// </summary>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>等待时间统计</returns>
+    ST_PriorityWaitStats GetPriorityWaitStats(EM_TaskPriority priority) const;
+
+    /// <summary>
+    /// 清空各优先级的排队等待统计
+    /// </summary>
+    void ResetPriorityWaitStats();
+
+    /// <summary>
+    /// 设置队列已满时的过载策略，可在运行时调整
+    /// </summary>
+    /// <param name="policy">过载策略</param>
+    /// <param name="timeout">Block策略的最长等待时间</param>
+    void SetOverloadPolicy(EM_OverloadPolicy policy, std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+    /// <summary>
+    /// 设置共享队列的任务数上限，可在运行时调整；队列按需分段增长，不会预先分配上限对应的内存
+    /// 上限在全局队列、分区本地队列与提交分片之间划分，合计不超过该值；
+    /// 工作窃取模式下工作线程本地队列中的任务、定向提交到工作线程收件箱的任务不计入上限
+    /// （本地队列不设上限，每个收件箱以创建时全局队列的上限为界）
+    /// </summary>
+    /// <param name="maxQueueSize">任务数上限</param>
+    void SetMaxQueueSize(size_t maxQueueSize);
+
+    /// <summary>
+    /// 切换调度配置档，无需重启线程池；正在自旋或休眠的线程在下一次等待任务时按新配置执行
+    /// </summary>
+    /// <param name="profile">调度配置档</param>
+    void SetSchedulingProfile(EM_SchedulingProfile profile);
+
+    /// <summary>
+    /// 获取当前调度配置档
+    /// </summary>
+    EM_SchedulingProfile GetSchedulingProfile() const { return m_profile.load(std::memory_order_relaxed); }
+
+    /// <summary>
+    /// 获取过载统计
+    /// </summary>
+    ST_OverloadStats GetOverloadStats() const;
+
+    /// <summary>
+    /// 调整线程池大小
+    /// </summary>
+    /// <param name="minThreads">最小线程数</param>
+    /// <param name="maxThreads">最大线程数</param>
+    void Resize(size_t minThreads, size_t maxThreads);
+
+    /// <summary>
+    /// 等待所有已提交的任务执行完毕，等待期间协助执行队列中的任务；线程池停止时立即返回
+    /// 不能在线程池任务中调用（当前任务本身尚未完成），在工作线程上调用时抛出std::logic_error
+    /// </summary>
+    void WaitAll();
+
+    /// <summary>
+    /// 当前线程是否为本线程池的工作线程
+    /// </summary>
+    bool IsWorkerThread() const;
+
+    /// <summary>
+    /// 停止线程池，队列中尚未执行的任务被丢弃，Submit返回的future以TaskCancelledException完成
+    /// </summary>
+    void Shutdown();
+
+    /// <summary>
+    /// 创建专用线程，线程执行完初始化函数后进入事件循环，处理通过PostToDedicatedThread投递的任务
+    /// </summary>
+    /// <param name="name">线程名称</param>
+    /// <param name="task">初始化函数，可为空；抛出异常时线程进入Error状态并退出</param>
+    /// <param name="cpuCore">绑定的CPU核心编号，-1表示不绑定；绑定失败时线程仍正常运行</param>
+    /// <returns>线程ID，用于后续管理</returns>
+    size_t CreateDedicatedThread(const std::string& name, std::function<void()> task = nullptr, int cpuCore = -1);
+
+    /// <summary>
+    /// 向专用线程的邮箱投递无需返回值的任务，同一线程的任务按投递顺序执行，任务抛出的异常被忽略
+    /// </summary>
+    /// <param name="threadId">线程ID</param>
+    /// <param name="f">任务函数</param>
+    /// <returns>线程不存在或已停止时返回false</returns>
+    template <typename F>
+    bool PostToDedicatedThread(size_t threadId, F&& f)
+    {
+        return EnqueueDedicatedTask(threadId, TaskFunction(std::forward<F>(f)));
+    }
+
+    /// <summary>
+    /// 向专用线程的邮箱提交任务
+    /// </summary>
+    /// <param name="threadId">线程ID</param>
+    /// <param name="f">任务函数</param>
+    /// <returns>future对象，用于获取任务结果</returns>
+    template <typename F>
+    auto SubmitToDedicatedThread(size_t threadId, F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>&>>
+    {
+        using ResultType = std::invoke_result_t<std::decay_t<F>&>;
+
+        CancellableCall<ResultType, std::decay_t<F>> call(std::forward<F>(f));
+        std::future<ResultType> result = call.GetFuture();
+        if (!EnqueueDedicatedTask(threadId, TaskFunction(std::move(call))))
+        {
+            throw std::runtime_error("Dedicated thread is not running");
+        }
+        return result;
+    }
+
+    /// <summary>
+    /// 停止专用线程，执行完邮箱中已有的任务后退出；在该专用线程内部调用时只请求停止，不等待
+    /// </summary>
+    /// <param name="threadId">线程ID</param>
+    /// <returns>是否成功停止</returns>
+    bool StopDedicatedThread(size_t threadId);
+
+    /// <summary>
+    /// 获取专用线程状态
+    /// </summary>
+    /// <param name="threadId">线程ID</param>
+    /// <returns>线程状态</returns>
+    EM_DedicatedThreadState GetDedicatedThreadState(size_t threadId) const;
+
+    /// <summary>
+    /// 获取所有专用线程的状态快照
+    /// </summary>
+    /// <returns>专用线程状态列表</returns>
+    std::vector<ST_DedicatedThreadStatus> GetAllDedicatedThreads() const;
+
+private:
+    friend class TimerWheel;
+    friend class ScopedBlocking;
+    friend class HelpingWaiter;
+
+    /// <summary>
+    /// 当前工作线程进入阻塞，必要时创建补偿线程
+    /// </summary>
+    void BeginBlocking();
+
+    /// <summary>
+    /// 当前工作线程结束阻塞，有多余线程时唤醒一个空闲线程让其退出
+    /// </summary>
+    void EndBlocking();
+
+    /// <summary>
+    /// 获取计入补偿线程后的目标线程数
+    /// </summary>
+    size_t EffectiveTargetThreads() const;
+
+    /// <summary>
+    /// 添加定时器，首次调用时创建时间轮及其定时线程
+    /// </summary>
+    TimerId AddTimer(std::chrono::steady_clock::time_point when, std::chrono::steady_clock::duration period, TaskFunction func, EM_TaskPriority priority);
+
+    /// <summary>
+    /// 并行区间任务，执行时继续拆分并处理区间；未执行就被销毁（线程池停止时清空队列）则记为失败，保证调用线程不会永久等待
+    /// </summary>
+    template <typename Body>
+    struct ST_ParallelRangeTask
+    {
+        ThreadPool* m_pool;              ///< 所属线程池
+        ST_ParallelContext* m_context;   ///< 共享状态，为空表示已执行或已移走
+        Body* m_body;                    ///< 区间处理函数
+        size_t m_begin;                  ///< 区间起始
+        size_t m_end;                    ///< 区间结束
+        size_t m_grain;                  ///< 拆分粒度
+
+        ST_ParallelRangeTask(ThreadPool* pool, ST_ParallelContext* context, Body* body, size_t begin, size_t end, size_t grain)
+            : m_pool(pool), m_context(context), m_body(body), m_begin(begin), m_end(end), m_grain(grain)
+        {
+        }
+
+        ST_ParallelRangeTask(ST_ParallelRangeTask&& other) noexcept
+            : m_pool(other.m_pool), m_context(other.m_context), m_body(other.m_body), m_begin(other.m_begin), m_end(other.m_end), m_grain(other.m_grain)
+        {
+            other.m_context = nullptr;
+        }
+
+        ST_ParallelRangeTask(const ST_ParallelRangeTask&) = delete;
+        ST_ParallelRangeTask& operator=(const ST_ParallelRangeTask&) = delete;
+        ST_ParallelRangeTask& operator=(ST_ParallelRangeTask&&) = delete;
+
+        ~ST_ParallelRangeTask()
+        {
+            if (m_context != nullptr)
+            {
+                m_context->Fail(std::make_exception_ptr(std::runtime_error("ThreadPool is stopped")));
+                m_context->m_pending.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        void operator()()
+        {
+            ST_ParallelContext* context = m_context;
+            m_context = nullptr;
+            m_pool->SplitParallelRange(context, m_body, m_begin, m_end, m_grain);
+            // 计数归零后调用线程可能立即返回，此后不能再访问context
+            context->m_pending.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    /// <summary>
+    /// 在当前线程处理区间：不断把右半部分入队，直到剩余一个粒度，再处理该子区间
+    /// 拆分点始终落在粒度的整数倍上，子区间边界与调度顺序无关
+    /// </summary>
+    template <typename Body>
+    void SplitParallelRange(ST_ParallelContext* context, Body* body, size_t begin, size_t end, size_t grain)
+    {
+        try
+        {
+            while (!context->m_failed.load(std::memory_order_relaxed))
+            {
+                size_t chunks = (end - begin + grain - 1) / grain;
+                if (chunks <= 1)
+                {
+                    (*body)(begin, end);
+                    return;
+                }
+
+                size_t middle = begin + (chunks / 2) * grain;
+                context->m_pending.fetch_add(1, std::memory_order_relaxed);
+                ST_Task task;
+                task.m_func = ST_ParallelRangeTask<Body>(this, context, body, middle, end, grain);
+                task.m_submitTime = std::chrono::steady_clock::now();
+                if (m_stop || !PushTask(std::move(task)))
+                {
+                    // 队列已满或线程池已停止时在当前线程处理右半部分
+                    task.m_func();
+                }
+                end = middle;
+            }
+        }
+        catch (...)
+        {
+            context->Fail(std::current_exception());
+        }
+    }
+
+    /// <summary>
+    /// 并行处理 [0, count)，body(chunkBegin, chunkEnd) 处理一个子区间；调用线程协助执行直到全部完成，再抛出第一个异常
+    /// </summary>
+    template <typename Body>
+    void RunParallelRange(size_t count, size_t grain, Body& body)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (grain == 0)
+        {
+            grain = AutoGrainSize(count);
+        }
+
+        ST_ParallelContext context;
+        SplitParallelRange(&context, &body, 0, count, grain);
+        while (context.m_pending.load(std::memory_order_acquire) != 0)
+        {
+            if (!RunPendingTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        if (context.m_exception)
+        {
+            std::rethrow_exception(context.m_exception);
+        }
+    }
+
+    /// <summary>
+    /// 并行度：当前工作线程数加上协助执行的调用线程
+    /// </summary>
+    size_t GetParallelism() const { return m_totalThreads.load(std::memory_order_relaxed) + 1; }
+
+    /// <summary>
+    /// 自动粒度：每个线程约分到8个子区间，兼顾负载均衡与调度开销
+    /// </summary>
+    size_t AutoGrainSize(size_t count) const { return std::max<size_t>(1, count / (GetParallelism() * 8)); }
+
+    /// <summary>
+    /// 在当前线程的统计实例中计入完成的任务，有WaitAll等待者且未完成任务数归零时唤醒等待者
+    /// </summary>
+    /// <param name="count">完成或丢弃的任务数</param>
+    void FinishTasks(size_t count);
+
+    /// <summary>
+    /// 汇总各统计实例得到未完成任务数，只在有WaitAll等待者时调用
+    /// 先汇总完成数再汇总入队数，任务的入队先于其完成，结果不会小于真实值
+    /// </summary>
+    uint64_t GetOutstandingTaskCount() const;
+
+    /// <summary>
+    /// 执行任务并记录排队等待时间
+    /// </summary>
+    /// <param name="task">任务对象</param>
+    void ExecuteTask(ST_Task& task);
+
+    /// <summary>
+    /// 按过载策略提交任务；仅在任务入队或已执行时取走任务，其余情况下任务保持不变，由调用者决定如何处理
+    /// </summary>
+    /// <param name="task">任务对象</param>
+    /// <param name="workerIndex">目标工作线程下标，SIZE_MAX表示不指定</param>
+    /// <returns>提交结果</returns>
+    EM_SubmitStatus SubmitTask(ST_Task& task, size_t workerIndex = SIZE_MAX);
+
+    /// <summary>
+    /// 提交失败时按Submit/Post的约定抛出异常：线程池已停止时总是抛出，队列已满时仅在Throw与Block策略下抛出
+    /// </summary>
+    /// <param name="status">提交结果</param>
+    void ThrowOnSubmitFailure(EM_SubmitStatus status) const;
+
+    /// <summary>
+    /// 将任务放入队列，工作窃取模式下工作线程内提交的任务进入其本地队列
+    /// </summary>
+    /// <param name="task">任务对象</param>
+    /// <param name="workerIndex">目标工作线程下标，SIZE_MAX表示不指定；指定时任务进入该线程的收件箱</param>
+    /// <returns>是否成功入队</returns>
+    bool PushTask(ST_Task&& task, size_t workerIndex = SIZE_MAX);
+
+    /// <summary>
+    /// 批量提交同一优先级的任务：先整批入队，放不下的任务逐个按过载策略提交
+    /// </summary>
+    /// <param name="tasks">任务，提交后被移走</param>
+    /// <param name="accepted">输出被接受（入队或在提交线程上执行）的任务数</param>
+    /// <returns>提交结果，有任务未被接受时返回第一个失败的结果</returns>
+    EM_SubmitStatus SubmitTasks(std::span<ST_Task> tasks, size_t& accepted);
+
+    /// <summary>
+    /// 批量将同一优先级的任务推入队列并唤醒线程，按PushTask的路由选择队列，每个队列只预留一次
+    /// </summary>
+    /// <param name="tasks">任务</param>
+    /// <returns>推入的任务数，即tasks中被取走的前缀长度</returns>
+    size_t PushTasks(std::span<ST_Task> tasks);
+
+    /// <summary>
+    /// 获取槽位的收件箱，不存在时创建
+    /// </summary>
+    /// <param name="slot">工作线程槽位</param>
+    PriorityTaskQueue& WorkerInbox(ST_WorkerSlot& slot);
+
+    /// <summary>
+    /// 从没有工作线程占用的槽位收件箱中取出任务，接管槽位释放前后竞争推入的定向任务
+    /// </summary>
+    /// <param name="task">输出任务</param>
+    /// <returns>是否获取到任务</returns>
+    bool TryPopOrphanedInbox(ST_Task& task);
+
+    /// <summary>
+    /// 局部性提示键的哈希值映射到常驻工作线程下标
+    /// </summary>
+    /// <param name="hash">键的哈希值</param>
+    size_t AffinityWorkerIndex(size_t hash) const;
+
+    /// <summary>
+    /// 按本地队列、所属分区队列、全局队列、分区内窃取、其他分区队列、跨分区窃取的顺序获取任务
+    /// </summary>
+    /// <param name="slot">当前工作线程槽位，可为空</param>
+    /// <param name="task">输出任务</param>
+    /// <returns>是否获取到任务</returns>
+    bool TryGetTask(ST_WorkerSlot* slot, ST_Task& task);
+
+    /// <summary>
+    /// 从随机选取的其他工作线程窃取任务
+    /// </summary>
+    /// <param name="self">当前工作线程槽位</param>
+    /// <param name="task">输出任务</param>
+    /// <param name="node">只从该分区的工作线程窃取，SIZE_MAX表示不限</param>
+    /// <returns>是否窃取成功</returns>
+    bool TrySteal(ST_WorkerSlot* self, ST_Task& task, size_t node = SIZE_MAX);
+
+    /// <summary>
+    /// 从其他分区的本地队列取任务
+    /// </summary>
+    /// <param name="node">当前分区，SIZE_MAX表示未知</param>
+    /// <param name="task">输出任务</param>
+    /// <returns>是否获取到任务</returns>
+    bool TryPopRemoteNode(size_t node, ST_Task& task);
+
+    /// <summary>
+    /// 从当前线程的轮转位置开始依次检查各提交分片，取出第一个非空分片中的任务
+    /// </summary>
+    /// <param name="slot">当前工作线程槽位，可为空；不为空时按配置档从同一分片批量预取</param>
+    /// <param name="task">输出任务</param>
+    /// <returns>是否获取到任务</returns>
+    bool TryPopSubmitShard(ST_WorkerSlot* slot, ST_Task& task);
+
+    /// <summary>
+    /// 从共享队列取到任务后，按配置档的出队批量再一次性取出若干普通及以下优先级任务放入本地队列，可被其他线程窃取
+    /// </summary>
+    /// <param name="slot">当前工作线程槽位，可为空</param>
+    /// <param name="queue">刚取出任务的共享队列</param>
+    void PrefetchBatch(ST_WorkerSlot* slot, PriorityTaskQueue& queue);
+
+    /// <summary>
+    /// 提交任务后唤醒工作线程；配置档启用唤醒批量且有线程自旋时，积压达到一批才额外唤醒
+    /// </summary>
+    /// <param name="preferredNode">优先唤醒该分区的线程，SIZE_MAX表示不限</param>
+    void WakeForSubmit(size_t preferredNode = SIZE_MAX);
+
+    /// <summary>
+    /// 批量提交后唤醒足够执行新任务的休眠线程，扣除正在自旋的线程；配置档启用唤醒批量时按批数唤醒
+    /// </summary>
+    /// <param name="taskCount">新入队的任务数</param>
+    /// <param name="ignoreSpinning">是否忽略正在自旋的线程（任务在本地队列中，自旋线程不一定能取到）</param>
+    /// <param name="preferredNode">优先唤醒该分区的线程，SIZE_MAX表示不限</param>
+    void WakeForBulkSubmit(size_t taskCount, bool ignoreSpinning, size_t preferredNode = SIZE_MAX);
+
+    /// <summary>
+    /// 全局队列、提交分片或任一分区队列中是否有任务
+    /// </summary>
+    bool HasQueuedTasks() const;
+
+    /// <summary>
+    /// 读取全局队列、各提交分片与各分区队列中最早任务的提交时间
+    /// </summary>
+    /// <param name="ticks">输出steady_clock计数</param>
+    /// <returns>队列非空时返回true</returns>
+    bool TryPeekOldestTicks(int64_t& ticks) const;
+
+    /// <summary>
+    /// 根据配置的CPU集合与NUMA拓扑划分CPU分区，启用NUMA划分且分区多于一个时创建各分区的本地队列
+    /// </summary>
+    void ConfigurePlacement();
+
+    /// <summary>
+    /// 在全局队列、分区本地队列与提交分片之间划分任务数上限
+    /// 前置队列已满时任务溢出到全局队列，因此各队列上限之和不能超过总上限；前置队列合计占一半，
+    /// 其余留给全局队列，容纳高优先级任务以及前置队列溢出的任务
+    /// </summary>
+    /// <param name="maxQueueSize">任务数上限</param>
+    void ApplyQueueLimits(size_t maxQueueSize);
+
+    /// <summary>
+    /// 把当前工作线程绑定到所属分区的CPU并设置线程名称
+    /// </summary>
+    /// <param name="slot">当前工作线程槽位，可为空</param>
+    void ApplyWorkerPlacement(ST_WorkerSlot* slot);
+
+    /// <summary>
+    /// 获取当前线程所在的分区：工作线程取所属分区，其他线程按当前运行的CPU查找
+    /// </summary>
+    /// <returns>分区下标，无法确定时返回SIZE_MAX</returns>
+    size_t CurrentNode() const;
+
+    /// <summary>
+    /// 获取全局队列与所有本地队列中的待执行任务数
+    /// </summary>
+    size_t GetPendingTaskCount() const;
+
+    /// <summary>
+    /// 为当前工作线程占用一个空闲槽位
+    /// </summary>
+    /// <returns>槽位指针，无空闲槽位时返回nullptr</returns>
+    ST_WorkerSlot* AcquireWorkerSlot();
+
+    /// <summary>
+    /// 释放工作线程槽位，剩余本地任务转移到全局队列
+    /// </summary>
+    /// <param name="slot">槽位指针</param>
+    void ReleaseWorkerSlot(ST_WorkerSlot* slot);
+
+    /// <summary>
+    /// 先自适应自旋再休眠，直到获取任务、超时或线程池停止
+    /// </summary>
+    /// <param name="slot">当前工作线程槽位</param>
+    /// <param name="task">输出任务</param>
+    /// <param name="deadline">休眠截止时间</param>
+    /// <returns>是否获取到任务</returns>
+    bool WaitForTask(ST_WorkerSlot* slot, ST_Task& task, std::chrono::steady_clock::time_point deadline);
+
+    /// <summary>
+    /// 将工作线程从休眠列表中移除（若仍在列表中）
+    /// </summary>
+    /// <param name="slot">工作线程槽位</param>
+    void CancelPark(ST_WorkerSlot* slot);
+
+    /// <summary>
+    /// 唤醒一个休眠中的工作线程，已有线程在自旋时默认跳过
+    /// </summary>
+    /// <param name="ignoreSpinning">是否忽略自旋线程强制唤醒</param>
+    /// <param name="preferredNode">优先唤醒该分区的线程，SIZE_MAX表示不限</param>
+    void WakeOneWorker(bool ignoreSpinning = false, size_t preferredNode = SIZE_MAX);
+
+    /// <summary>
+    /// 获取可在协助等待时休眠的当前工作线程槽位，非本线程池的工作线程或线程池已停止时返回空
+    /// </summary>
+    ST_WorkerSlot* CurrentHelpingSlot() const;
+
+    /// <summary>
+    /// 协助等待中的工作线程登记到休眠列表后重新检查队列，取到任务或线程池已停止时取消登记
+    /// </summary>
+    /// <param name="slot">工作线程槽位</param>
+    /// <param name="task">输出取到的任务，由调用方执行</param>
+    /// <returns>是否仍在休眠列表中</returns>
+    bool BeginHelpingPark(ST_WorkerSlot* slot, ST_Task& task);
+
+    /// <summary>
+    /// 协助等待中的工作线程休眠直到被唤醒（新任务提交、等待点通知或线程池停止），返回前从休眠列表移除
+    /// </summary>
+    /// <param name="slot">工作线程槽位</param>
+    /// <param name="sleep">是否休眠，为假时只取消登记</param>
+    void EndHelpingPark(ST_WorkerSlot* slot, bool sleep);
+
+    /// <summary>
+    /// 指定工作线程正在休眠时唤醒它
+    /// </summary>
+    /// <param name="slot">工作线程槽位</param>
+    void WakeWorker(ST_WorkerSlot* slot);
+
+    /// <summary>
+    /// 向已从休眠列表移除的工作线程发送唤醒信号
+    /// </summary>
+    /// <param name="slot">工作线程槽位</param>
+    void SignalWorker(ST_WorkerSlot* slot);
+
+    /// <summary>
+    /// 唤醒所有休眠中的工作线程
+    /// </summary>
+    void WakeAllWorkers();
+
+    /// <summary>
+    /// 工作线程函数
+    /// </summary>
+    void WorkerThread();
+
+    /// <summary>
+    /// 按配置修正目标线程数，补足不足的工作线程，必要时启动线程数控制器；多出的线程在执行完当前任务后自行退出
+    /// </summary>
+    void AdjustThreadCount();
+
+    /// <summary>
+    /// 线程数控制器未运行且允许伸缩时启动控制器
+    /// </summary>
+    void EnsureMonitorThread();
+
+    /// <summary>
+    /// 线程数控制器：周期性采样吞吐量与排队等待时间，以爬山法调整目标线程数
+    /// 最早任务等待超过一个采样间隔视为积压；积压时吞吐量提升超过滞回阈值则沿当前方向继续调整，下降超过阈值则反向，
+    /// 变化在阈值内说明线程数不是瓶颈，倾向于减少线程；积压但整个间隔内无任务完成时视为饥饿，直接增加线程
+    /// </summary>
+    void MonitorThread();
+
+    /// <summary>
+    /// 汇总各工作线程已执行的任务数
+    /// </summary>
+    uint64_t GetExecutedTaskCount() const;
+
+    /// <summary>
+    /// 获取当前线程写入的统计：工作线程使用自己槽位中的实例，其他线程使用各自的本地状态
+    /// </summary>
+    ST_ThreadStats& CurrentStats();
+
+    /// <summary>
+    /// 获取当前非工作线程在本线程池中的本地状态，首次访问时占用或创建
+    /// </summary>
+    ST_ExternalThreadState& CurrentExternalState();
+
+    /// <summary>
+    /// 把一次任务执行写入当前线程的轨迹缓冲
+    /// </summary>
+    /// <param name="task">已执行的任务</param>
+    /// <param name="beginTime">开始执行时间</param>
+    /// <param name="endTime">执行结束时间</param>
+    void RecordTrace(const ST_Task& task, std::chrono::steady_clock::time_point beginTime, std::chrono::steady_clock::time_point endTime);
+
+    /// <summary>
+    /// 遍历所有统计实例（已创建的槽位统计与非工作线程统计）
+    /// </summary>
+    template <typename Visitor>
+    void ForEachStats(Visitor&& visitor) const
+    {
+        size_t highWater = m_workerSlotHighWater.load(std::memory_order_acquire);
+        for (size_t i = 0; i < highWater; ++i)
+        {
+            if (const ST_ThreadStats* stats = m_workerSlots[i].m_stats.load(std::memory_order_acquire))
+            {
+                visitor(*stats);
+            }
+        }
+        m_externalThreads->ForEach([&visitor](const ST_ExternalThreadState& state) { visitor(state.m_stats); });
+        visitor(m_externalThreads->m_shared.m_stats);
+    }
+
+    /// <summary>
+    /// 尝试让当前工作线程退出：总线程数大于下限时递减并返回true，并发退出也不会低于下限
+    /// </summary>
+    /// <param name="floor">线程数下限</param>
+    bool TryRetireWorker(size_t floor);
+
+    /// <summary>
+    /// 登记当前工作线程即将退出，供之后回收其线程句柄
+    /// </summary>
+    void MarkWorkerExited();
+
+    /// <summary>
+    /// 回收已退出工作线程的句柄，调用者需持有m_workersMutex
+    /// </summary>
+    void ReapExitedWorkers();
+
+    /// <summary>
+    /// 创建新的工作线程
+    /// </summary>
+    void CreateWorkerThread();
+
+    /// <summary>
+    /// 专用线程工作函数
+    /// </summary>
+    /// <param name="threadInfo">线程信息</param>
+    void DedicatedThreadWorker(std::shared_ptr<ST_DedicatedThreadInfo> threadInfo);
+
+    /// <summary>
+    /// 任务放入专用线程邮箱，事件循环休眠时唤醒它
+    /// </summary>
+    /// <param name="threadId">线程ID</param>
+    /// <param name="func">任务函数</param>
+    /// <returns>线程不存在或已停止时返回false</returns>
+    bool EnqueueDedicatedTask(size_t threadId, TaskFunction&& func);
+
+    /// <summary>
+    /// 邮箱为空时等待新任务，先短暂自旋再休眠
+    /// </summary>
+    /// <param name="info">线程信息</param>
+    /// <param name="spinCount">休眠前的自旋次数，由调度配置档决定</param>
+    /// <returns>已请求停止且邮箱为空时返回false</returns>
+    static bool WaitForDedicatedTask(ST_DedicatedThreadInfo& info, size_t spinCount);
+
+    /// <summary>
+    /// 请求专用线程停止并等待其退出
+    /// </summary>
+    /// <param name="info">线程信息</param>
+    static void JoinDedicatedThread(ST_DedicatedThreadInfo& info);
+
+private:
+    std::vector<std::thread> m_workers; ///< 工作线程集合
+    PriorityTaskQueue m_tasks; ///< 多优先级无锁任务队列
+    mutable std::shared_mutex m_configMutex; ///< 配置互斥锁
     mutable std::mutex m_workersMutex; ///< 工作线程集合互斥锁
-    std::condition_variable_any m_condition; ///< 条件变量
+    std::mutex m_parkMutex; ///< 休眠线程列表互斥锁
+    std::vector<ST_WorkerSlot*> m_parkedWorkers; ///< 休眠中的工作线程
+    std::atomic<size_t> m_parkedCount{0}; ///< 休眠中的工作线程数，为0时提交任务无需加锁
+    std::atomic<size_t> m_spinningCount{0}; ///< 自旋等待中的工作线程数，不为0时提交任务无需唤醒
     ST_ThreadPoolConfig m_config; ///< 线程池配置
     std::atomic<bool> m_stop{false}; ///< 停止标志
     std::atomic<size_t> m_totalThreads{0}; ///< 总线程数
     std::atomic<size_t> m_activeThreads{0}; ///< 活动线程数
     std::atomic<bool> m_adjusting{false}; ///< 线程池调整标志
     std::unordered_map<size_t, std::shared_ptr<ST_DedicatedThreadInfo>> m_dedicatedThreads; ///< 专用线程集合
-    mutable std::mutex m_dedicatedThreadsMutex; ///< 专用线程集合互斥锁
+    mutable std::shared_mutex m_dedicatedThreadsMutex; ///< 专用线程集合读写锁，投递任务只需读锁；线程信息在线程池析构前不会移除
     std::atomic<size_t> m_nextThreadId{0}; ///< 下一个线程ID
+    static constexpr size_t DEDICATED_DRAIN_BATCH = 64; ///< 专用线程每批执行的邮箱任务数上限，每批只更新一次计数
+    static constexpr size_t MAX_WORKER_SLOTS = 256; ///< 工作线程槽位上限
+    std::unique_ptr<ST_WorkerSlot[]> m_workerSlots; ///< 工作线程槽位
+    uint64_t m_poolId; ///< 线程池编号，进程内唯一，线程本地缓存据此识别线程池（地址可能被新线程池复用）
+    std::shared_ptr<ST_ExternalThreadRegistry> m_externalThreads; ///< 非工作线程的本地状态（统计与轨迹缓冲）
+    static constexpr size_t DEFAULT_TRACE_EVENTS = 65536; ///< 默认每个线程保留的轨迹记录数
+    std::atomic<bool> m_tracing{false}; ///< 是否记录执行轨迹
+    std::atomic<size_t> m_traceEventsPerThread{DEFAULT_TRACE_EVENTS}; ///< 新建轨迹缓冲的容量
+    std::atomic<size_t> m_workerSlotHighWater{0}; ///< 已使用过的最大槽位数，窃取时只遍历该范围
+    std::vector<std::vector<int>> m_nodeCpus; ///< 各CPU分区包含的CPU编号，未配置CPU集合且未启用NUMA划分时为空
+    std::vector<int> m_cpuToNode; ///< CPU编号到分区下标的映射，-1表示不属于任何分区
+    std::vector<std::unique_ptr<PriorityTaskQueue>> m_nodeQueues; ///< 各分区的本地队列，只有一个分区时为空；队列已满时任务进入全局队列
+    std::vector<std::unique_ptr<PriorityTaskQueue>> m_submitShards; ///< 提交分片，分片数为1时为空；分片已满时任务进入全局队列，上限见ApplyQueueLimits
+    static constexpr size_t MAX_SUBMIT_SHARDS = 64; ///< 自动选择时的提交分片数上限
+    static constexpr size_t SUBMIT_SHARD_LANE_CAPACITY = 64; ///< 提交分片每条通道第一段的容量，分片按需增长
+    std::atomic<size_t> m_residentWorkers{1}; ///< SubmitNear映射的工作线程数（最小线程数，至少为1），与m_config同步，提交路径无需加锁读取
+    static constexpr size_t SERIAL_SORT_THRESHOLD = 4096; ///< 不超过该元素数时ParallelSort直接串行排序
+    alignas(THREAD_POOL_CACHE_LINE_SIZE) std::atomic<size_t> m_idleWaiters{0}; ///< 休眠在WaitAll中的等待者数，为0时完成任务不汇总计数（独占缓存行）
+    std::mutex m_idleMutex; ///< 空闲通知互斥锁
+    std::condition_variable m_idleCondition; ///< 未完成任务数归零时通知WaitAll
+    std::unique_ptr<TimerWheel> m_timerWheel; ///< 定时器时间轮，首次使用时创建
+    std::once_flag m_timerWheelOnce; ///< 时间轮创建标志
+    std::mutex m_timerSlackMutex; ///< 保护时间轮的创建与切换配置档时的合并间隔设置，两者互斥，不会使用过期的配置档
+    std::atomic<EM_OverloadPolicy> m_overloadPolicy{EM_OverloadPolicy::Throw}; ///< 过载策略，与m_config同步，提交路径无需加锁读取
+    std::atomic<EM_SchedulingProfile> m_profile{EM_SchedulingProfile::Balanced}; ///< 调度配置档，与m_config同步，等待与提交路径无需加锁读取
+    std::atomic<size_t> m_submitsSinceWake{0}; ///< 上次唤醒之后未唤醒线程的提交次数，仅在启用唤醒批量时使用
+    std::atomic<int64_t> m_overloadTimeoutMs{0}; ///< Block策略的最长等待时间(毫秒)
+    std::atomic<uint64_t> m_droppedCount{0}; ///< 被挤出队列的旧任务数
+    std::atomic<uint64_t> m_callerRunsCount{0}; ///< 在提交线程上执行的任务数
+    std::atomic<uint64_t> m_blockedCount{0}; ///< 阻塞等待空位的提交次数
+    static constexpr std::chrono::microseconds OVERLOAD_BLOCK_SLEEP{50}; ///< Block策略无任务可协助时的休眠间隔
+    std::atomic<size_t> m_targetThreads{0}; ///< 控制器给出的目标线程数（不含补偿线程），多于该值的工作线程执行完当前任务后退出
+    std::atomic<size_t> m_blockingWorkers{0}; ///< 正在ScopedBlocking中阻塞的工作线程数
+    std::atomic<uint64_t> m_compensationCount{0}; ///< 创建补偿线程的次数
+    std::vector<std::thread::id> m_exitedWorkers; ///< 已退出但尚未回收的工作线程（受m_workersMutex保护）
+    std::thread m_monitorThread; ///< 线程数控制器线程
+    std::mutex m_monitorMutex; ///< 控制器休眠互斥锁
+    std::condition_variable m_monitorCondition; ///< 控制器休眠条件变量，停止时唤醒
+    static constexpr std::chrono::milliseconds CONTROL_INTERVAL{100}; ///< 控制器采样间隔
+    static constexpr double THROUGHPUT_HYSTERESIS = 0.05; ///< 吞吐量相对变化不超过该比例时视为无变化
+    static constexpr size_t MAX_STEP_SHIFT = 3; ///< 同方向连续调整时步长按2的幂增长，最多8个线程
 };
+
+template <typename Predicate>
+void HelpingWaiter::Wait(Predicate predicate)
+{
+    while (!predicate())
+    {
+        if (m_pool.RunPendingTask())
+        {
+            continue;
+        }
+
+        ST_Task task;
+        ST_WorkerSlot* slot = m_pool.CurrentHelpingSlot();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_waiters;
+        if (slot == nullptr)
+        {
+            m_condition.wait(lock, predicate);
+        }
+        else if (!predicate())
+        {
+            // 先登记槽位再登记到休眠列表，之后重新检查队列与条件：NotifyAll在锁内唤醒已登记的槽位，
+            // 提交者入队后唤醒休眠列表中的线程，两边都不会丢失唤醒
+            m_parkedSlots.push_back(slot);
+            lock.unlock();
+            if (m_pool.BeginHelpingPark(slot, task))
+            {
+                m_pool.EndHelpingPark(slot, !predicate());
+            }
+            lock.lock();
+            m_parkedSlots.erase(std::find(m_parkedSlots.begin(), m_parkedSlots.end(), slot));
+        }
+        --m_waiters;
+        lock.unlock();
+
+        // 登记期间取到的任务在离开等待点后执行，任务中可以再次等待同一等待点
+        if (task.m_func)
+        {
+            m_pool.ExecuteTask(task);
+        }
+    }
+
+    // 与最后一次通知同步，保证通知方已离开临界区
+    std::lock_guard<std::mutex> lock(m_mutex);
+}
+
+inline void ST_ScheduleAwaitable::await_suspend(std::coroutine_handle<> handle)
+{
+    // 投递失败时恢复任务在析构中以取消恢复协程，协程可能在TryPost返回前就已恢复甚至结束，此后不能再访问this
+    try
+    {
+        m_pool->TryPost(ST_ResumeTask(handle, &m_cancelled), m_priority);
+    }
+    catch (...)
+    {
+        // 抛出异常时恢复任务已被销毁并恢复了协程，不能再让异常从await_suspend传出
+    }
+}
+
+inline void ST_DelayAwaitable::await_suspend(std::coroutine_handle<> handle)
+{
+    // 同上，SubmitAt在线程池已停止时抛出异常，此时恢复任务已以取消恢复了协程
+    try
+    {
+        m_pool->SubmitAt(m_when, ST_ResumeTask(handle, &m_cancelled), m_priority);
+    }
+    catch (...)
+    {
+    }
+}
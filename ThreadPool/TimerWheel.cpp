@@ -0,0 +1,376 @@
+﻿/// <summary>
+/// 分层时间轮实现文件
+/// </summary>
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(ThreadPool& pool)
+    : m_pool(pool)
+    , m_startTime(Clock::now())
+{
+    m_thread = std::thread([this]() { TimerThread(); });
+}
+
+TimerWheel::~TimerWheel()
+{
+    Stop();
+}
+
+TimerId TimerWheel::Add(Clock::time_point when, Clock::duration period, TaskFunction func, EM_TaskPriority priority)
+{
+    std::shared_ptr<ST_PeriodicState> periodic;
+    if (period > Clock::duration::zero())
+    {
+        periodic = std::make_shared<ST_PeriodicState>();
+        periodic->m_func = std::move(func);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stop)
+    {
+        throw std::runtime_error("ThreadPool is stopped");
+    }
+
+    // 时间轮为空时定时线程不推进tick，插入前先追上当前时间
+    if (m_pendingCount == 0)
+    {
+        m_nextTick = std::max(m_nextTick, CurrentTick());
+    }
+
+    ST_TimerNode* node = AllocateNode();
+    node->m_expireTick = ToTick(when);
+    node->m_periodTicks = periodic ? std::max<uint64_t>(1, (period + TICK - Clock::duration(1)) / TICK) : 0;
+    node->m_priority = priority;
+    node->m_func = periodic ? TaskFunction() : std::move(func);
+    node->m_periodic = std::move(periodic);
+    Insert(node);
+
+    // 新定时器早于定时线程计划醒来的时间时提前唤醒
+    uint64_t wakeTick = ApplySlack(node->m_expireTick);
+    if (wakeTick < m_wakeTick)
+    {
+        m_wakeTick = wakeTick;
+        m_condition.notify_one();
+    }
+    return (static_cast<TimerId>(node->m_generation) << 32) | node->m_index;
+}
+
+void TimerWheel::SetSlack(Clock::duration slack)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_slackTicks = slack > Clock::duration::zero() ? static_cast<uint64_t>(slack / TICK) : 0;
+    }
+    // 让定时线程按新的间隔重新计算醒来时间
+    m_condition.notify_one();
+}
+
+bool TimerWheel::Cancel(TimerId id)
+{
+    uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index >= m_nodes.size())
+    {
+        return false;
+    }
+
+    ST_TimerNode* node = m_nodes[index].get();
+    if (node->m_generation != generation || !node->m_active)
+    {
+        return false;
+    }
+
+    Unlink(node);
+    FreeNode(node);
+    return true;
+}
+
+void TimerWheel::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop)
+        {
+            return;
+        }
+        m_stop = true;
+    }
+    m_condition.notify_one();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+
+    // 丢弃未到期的定时器
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& node : m_nodes)
+    {
+        if (node->m_active)
+        {
+            Unlink(node.get());
+            FreeNode(node.get());
+        }
+    }
+}
+
+size_t TimerWheel::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingCount;
+}
+
+void TimerWheel::TimerThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop)
+    {
+        if (m_pendingCount == 0)
+        {
+            m_wakeTick = UINT64_MAX;
+            m_condition.wait(lock, [this]() { return m_stop || m_pendingCount > 0; });
+            continue;
+        }
+
+        // 处理到当前时间为止的所有tick
+        uint64_t nowTick = CurrentTick();
+        while (m_nextTick <= nowTick && m_pendingCount > 0)
+        {
+            ProcessTick(m_nextTick);
+            ++m_nextTick;
+        }
+        if (m_pendingCount == 0)
+        {
+            continue;
+        }
+
+        m_wakeTick = ApplySlack(NextWakeTick());
+        m_condition.wait_until(lock, ToTimePoint(m_wakeTick));
+    }
+}
+
+void TimerWheel::ProcessTick(uint64_t tick)
+{
+    size_t index = static_cast<size_t>(tick & (LEVEL0_SIZE - 1));
+
+    // 第0层转完一圈时把上层当前槽位下放，某层槽位下标回到0时继续下放更高一层
+    if (index == 0)
+    {
+        for (size_t level = 0; level < UPPER_LEVELS; ++level)
+        {
+            size_t upperIndex = static_cast<size_t>((tick >> (LEVEL0_BITS + LEVEL_BITS * level)) & (LEVEL_SIZE - 1));
+            ST_TimerLink cascade;
+            ST_TimerLink& slot = m_upperLevels[level][upperIndex];
+            if (!slot.IsEmpty())
+            {
+                // 整条链表转移到临时表头后逐个重新插入
+                cascade.m_next = slot.m_next;
+                cascade.m_prev = slot.m_prev;
+                cascade.m_next->m_prev = &cascade;
+                cascade.m_prev->m_next = &cascade;
+                slot.m_next = slot.m_prev = &slot;
+
+                while (!cascade.IsEmpty())
+                {
+                    ST_TimerNode* node = static_cast<ST_TimerNode*>(cascade.m_next);
+                    Unlink(node);
+                    Insert(node);
+                }
+            }
+            if (upperIndex != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    ST_TimerLink& slot = m_level0[index];
+    ST_TimerLink expired;
+    if (!slot.IsEmpty())
+    {
+        expired.m_next = slot.m_next;
+        expired.m_prev = slot.m_prev;
+        expired.m_next->m_prev = &expired;
+        expired.m_prev->m_next = &expired;
+        slot.m_next = slot.m_prev = &slot;
+    }
+
+    while (!expired.IsEmpty())
+    {
+        ST_TimerNode* node = static_cast<ST_TimerNode*>(expired.m_next);
+        Unlink(node);
+        if (node->m_expireTick > tick)
+        {
+            // 超出时间轮跨度的定时器尚未到期，重新插入
+            Insert(node);
+        }
+        else
+        {
+            Fire(node, tick);
+        }
+    }
+}
+
+void TimerWheel::Fire(ST_TimerNode* node, uint64_t tick)
+{
+    ST_Task task;
+    task.m_priority = node->m_priority;
+    task.m_submitTime = Clock::now();
+
+    if (node->m_periodic)
+    {
+        // 上一次尚未执行完时跳过本次，避免同一周期任务并发执行
+        std::shared_ptr<ST_PeriodicState> state = node->m_periodic;
+        if (!state->m_running.exchange(true, std::memory_order_acq_rel))
+        {
+            task.m_func = [state]()
+            {
+                try
+                {
+                    state->m_func();
+                }
+                catch (...) {}
+                state->m_running.store(false, std::memory_order_release);
+            };
+            if (!m_pool.PushTask(std::move(task)))
+            {
+                state->m_running.store(false, std::memory_order_release);
+            }
+        }
+
+        // 固定频率重新插入，落后超过一个周期时从当前tick重新计算
+        node->m_expireTick += node->m_periodTicks;
+        if (node->m_expireTick <= tick)
+        {
+            node->m_expireTick = tick + node->m_periodTicks;
+        }
+        Insert(node);
+        return;
+    }
+
+    task.m_func = std::move(node->m_func);
+    if (!m_pool.PushTask(std::move(task)))
+    {
+        // 队列已满时保留任务，下一个tick重试
+        node->m_func = std::move(task.m_func);
+        node->m_expireTick = tick + 1;
+        Insert(node);
+        return;
+    }
+    FreeNode(node);
+}
+
+void TimerWheel::Insert(ST_TimerNode* node)
+{
+    uint64_t expire = std::max(node->m_expireTick, m_nextTick);
+    uint64_t delta = expire - m_nextTick;
+
+    ST_TimerLink* slot = nullptr;
+    if (delta < LEVEL0_SIZE)
+    {
+        slot = &m_level0[expire & (LEVEL0_SIZE - 1)];
+    }
+    else
+    {
+        // 超出跨度的定时器放在最高层最远的位置，到达后再次检查
+        if (delta >= MAX_SPAN)
+        {
+            expire = m_nextTick + MAX_SPAN - 1;
+            delta = MAX_SPAN - 1;
+        }
+
+        size_t level = 0;
+        while (delta >= (uint64_t(1) << (LEVEL0_BITS + LEVEL_BITS * (level + 1))))
+        {
+            ++level;
+        }
+        slot = &m_upperLevels[level][(expire >> (LEVEL0_BITS + LEVEL_BITS * level)) & (LEVEL_SIZE - 1)];
+    }
+
+    node->m_prev = slot->m_prev;
+    node->m_next = slot;
+    slot->m_prev->m_next = node;
+    slot->m_prev = node;
+    if (!node->m_active)
+    {
+        node->m_active = true;
+        ++m_pendingCount;
+    }
+}
+
+void TimerWheel::Unlink(ST_TimerNode* node)
+{
+    node->m_prev->m_next = node->m_next;
+    node->m_next->m_prev = node->m_prev;
+    node->m_prev = node->m_next = node;
+}
+
+TimerWheel::ST_TimerNode* TimerWheel::AllocateNode()
+{
+    if (!m_freeNodes.empty())
+    {
+        ST_TimerNode* node = m_nodes[m_freeNodes.back()].get();
+        m_freeNodes.pop_back();
+        return node;
+    }
+
+    m_nodes.push_back(std::make_unique<ST_TimerNode>());
+    ST_TimerNode* node = m_nodes.back().get();
+    node->m_index = static_cast<uint32_t>(m_nodes.size() - 1);
+    return node;
+}
+
+void TimerWheel::FreeNode(ST_TimerNode* node)
+{
+    if (node->m_active)
+    {
+        node->m_active = false;
+        --m_pendingCount;
+    }
+    ++node->m_generation;
+    node->m_func = nullptr;
+    node->m_periodic.reset();
+    m_freeNodes.push_back(node->m_index);
+}
+
+uint64_t TimerWheel::NextWakeTick() const
+{
+    // 在第0层转完这一圈之前寻找最近的非空槽位，找不到则在下一圈开始时醒来下放上层定时器
+    uint64_t boundary = (m_nextTick | (LEVEL0_SIZE - 1)) + 1;
+    for (uint64_t tick = m_nextTick; tick < boundary; ++tick)
+    {
+        if (!m_level0[tick & (LEVEL0_SIZE - 1)].IsEmpty())
+        {
+            return tick;
+        }
+    }
+    return boundary;
+}
+
+uint64_t TimerWheel::ApplySlack(uint64_t tick) const
+{
+    if (m_slackTicks <= 1)
+    {
+        return tick;
+    }
+    return (tick + m_slackTicks - 1) / m_slackTicks * m_slackTicks;
+}
+
+uint64_t TimerWheel::ToTick(Clock::time_point when) const
+{
+    if (when <= m_startTime)
+    {
+        return 0;
+    }
+    return static_cast<uint64_t>((when - m_startTime + TICK - Clock::duration(1)) / TICK);
+}
+
+uint64_t TimerWheel::CurrentTick() const
+{
+    return static_cast<uint64_t>((Clock::now() - m_startTime) / TICK);
+}
+
+TimerWheel::Clock::time_point TimerWheel::ToTimePoint(uint64_t tick) const
+{
+    return m_startTime + TICK * static_cast<int64_t>(tick);
+}
@@ -0,0 +1,193 @@
+﻿/// <summary>
+/// 分层时间轮头文件 - 线程池的延迟与周期任务调度
+/// </summary>
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ThreadPool.h"
+
+/// <summary>
+/// 分层时间轮
+/// 精度为1毫秒的tick；第0层256个槽位各覆盖1个tick，第1~4层各64个槽位，逐层扩大64倍，总跨度约49天，更远的定时器在最高层循环等待。
+/// 每个槽位是带哨兵的侵入式双向链表，插入与取消都是O(1)；定时器编号由节点下标与代数组成，取消时无需查找。
+/// 由一个定时线程推进时间轮，到期任务直接放入线程池的普通任务队列
+/// </summary>
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;           ///< 时钟类型
+    static constexpr Clock::duration TICK = std::chrono::milliseconds(1); ///< tick时长
+
+    /// <summary>
+    /// 构造函数，启动定时线程
+    /// </summary>
+    /// <param name="pool">到期任务投递的线程池</param>
+    explicit TimerWheel(ThreadPool& pool);
+
+    /// <summary>
+    /// 析构函数，停止定时线程并丢弃未到期的定时器
+    /// </summary>
+    ~TimerWheel();
+
+    // 禁用拷贝构造和赋值
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /// <summary>
+    /// 添加定时器
+    /// </summary>
+    /// <param name="when">首次到期时间</param>
+    /// <param name="period">周期，为0表示一次性定时器</param>
+    /// <param name="func">任务函数；周期定时器每次到期调用同一个对象，上一次尚未执行完时跳过本次</param>
+    /// <param name="priority">任务优先级</param>
+    /// <returns>定时器编号</returns>
+    TimerId Add(Clock::time_point when, Clock::duration period, TaskFunction func, EM_TaskPriority priority);
+
+    /// <summary>
+    /// 设置唤醒合并间隔：定时线程的醒来时间向上对齐到该间隔的整数倍，多个定时器合并为一次唤醒，定时器最多推迟一个间隔触发
+    /// </summary>
+    /// <param name="slack">合并间隔，不超过1个tick时不合并</param>
+    void SetSlack(Clock::duration slack);
+
+    /// <summary>
+    /// 取消定时器
+    /// </summary>
+    /// <param name="id">定时器编号</param>
+    /// <returns>是否取消成功；一次性定时器已到期或编号无效时返回false</returns>
+    bool Cancel(TimerId id);
+
+    /// <summary>
+    /// 停止定时线程，丢弃所有未到期的定时器
+    /// </summary>
+    void Stop();
+
+    /// <summary>
+    /// 获取未到期的定时器数量
+    /// </summary>
+    size_t GetPendingCount() const;
+
+private:
+    static constexpr size_t LEVEL0_BITS = 8;                    ///< 第0层槽位位数
+    static constexpr size_t LEVEL_BITS = 6;                     ///< 上层槽位位数
+    static constexpr size_t LEVEL0_SIZE = size_t(1) << LEVEL0_BITS; ///< 第0层槽位数
+    static constexpr size_t LEVEL_SIZE = size_t(1) << LEVEL_BITS;   ///< 上层槽位数
+    static constexpr size_t UPPER_LEVELS = 4;                   ///< 上层层数
+    static constexpr uint64_t MAX_SPAN = uint64_t(1) << (LEVEL0_BITS + LEVEL_BITS * UPPER_LEVELS); ///< 时间轮可直接容纳的tick跨度
+
+    /// <summary>
+    /// 侵入式双向链表链接
+    /// </summary>
+    struct ST_TimerLink
+    {
+        ST_TimerLink* m_prev{this}; ///< 前一个节点
+        ST_TimerLink* m_next{this}; ///< 后一个节点
+
+        bool IsEmpty() const { return m_next == this; }
+    };
+
+    /// <summary>
+    /// 周期定时器的共享状态，投递出去的任务与时间轮节点共同持有
+    /// </summary>
+    struct ST_PeriodicState
+    {
+        TaskFunction m_func;              ///< 任务函数
+        std::atomic<bool> m_running{false}; ///< 上一次投递是否仍未执行完
+    };
+
+    /// <summary>
+    /// 定时器节点
+    /// </summary>
+    struct ST_TimerNode : ST_TimerLink
+    {
+        uint32_t m_index{0};                          ///< 节点下标
+        uint32_t m_generation{0};                     ///< 代数，节点释放时递增，使旧编号失效
+        bool m_active{false};                         ///< 是否在时间轮中
+        uint64_t m_expireTick{0};                     ///< 到期tick
+        uint64_t m_periodTicks{0};                    ///< 周期tick数，0表示一次性
+        EM_TaskPriority m_priority{EM_TaskPriority::Normal}; ///< 任务优先级
+        TaskFunction m_func;                          ///< 一次性定时器的任务函数
+        std::shared_ptr<ST_PeriodicState> m_periodic; ///< 周期定时器的共享状态
+    };
+
+    /// <summary>
+    /// 定时线程函数
+    /// </summary>
+    void TimerThread();
+
+    /// <summary>
+    /// 处理一个tick：必要时把上层槽位下放，再触发第0层对应槽位中的定时器
+    /// </summary>
+    void ProcessTick(uint64_t tick);
+
+    /// <summary>
+    /// 触发到期节点：投递任务，周期定时器重新插入，一次性定时器释放节点
+    /// </summary>
+    void Fire(ST_TimerNode* node, uint64_t tick);
+
+    /// <summary>
+    /// 按到期tick把节点插入对应层的槽位
+    /// </summary>
+    void Insert(ST_TimerNode* node);
+
+    /// <summary>
+    /// 把节点从所在槽位摘除
+    /// </summary>
+    static void Unlink(ST_TimerNode* node);
+
+    /// <summary>
+    /// 分配节点
+    /// </summary>
+    ST_TimerNode* AllocateNode();
+
+    /// <summary>
+    /// 释放节点，使其编号失效
+    /// </summary>
+    void FreeNode(ST_TimerNode* node);
+
+    /// <summary>
+    /// 计算下一个需要醒来的tick
+    /// </summary>
+    uint64_t NextWakeTick() const;
+
+    /// <summary>
+    /// 时间点换算为tick（向上取整，保证不早于该时间触发）
+    /// </summary>
+    uint64_t ToTick(Clock::time_point when) const;
+
+    /// <summary>
+    /// 当前时间所在的tick（向下取整，只处理已经完整经过的tick）
+    /// </summary>
+    uint64_t CurrentTick() const;
+
+    /// <summary>
+    /// 按唤醒合并间隔把醒来的tick向上对齐
+    /// </summary>
+    uint64_t ApplySlack(uint64_t tick) const;
+
+    /// <summary>
+    /// tick换算为时间点
+    /// </summary>
+    Clock::time_point ToTimePoint(uint64_t tick) const;
+
+private:
+    ThreadPool& m_pool;                                            ///< 线程池
+    const Clock::time_point m_startTime;                           ///< tick 0对应的时间
+    std::array<ST_TimerLink, LEVEL0_SIZE> m_level0;                ///< 第0层槽位
+    std::array<std::array<ST_TimerLink, LEVEL_SIZE>, UPPER_LEVELS> m_upperLevels; ///< 第1~4层槽位
+    std::vector<std::unique_ptr<ST_TimerNode>> m_nodes;            ///< 所有节点
+    std::vector<uint32_t> m_freeNodes;                             ///< 空闲节点下标
+    uint64_t m_nextTick{0};                                        ///< 下一个待处理的tick
+    uint64_t m_wakeTick{0};                                        ///< 定时线程计划醒来的tick
+    uint64_t m_slackTicks{0};                                      ///< 唤醒合并间隔(tick)，0或1表示不合并
+    size_t m_pendingCount{0};                                      ///< 时间轮中的定时器数量
+    bool m_stop{false};                                            ///< 停止标志
+    mutable std::mutex m_mutex;                                    ///< 时间轮互斥锁
+    std::condition_variable m_condition;                           ///< 定时线程等待条件
+    std::thread m_thread;                                          ///< 定时线程
+};
@@ -9,17 +9,26 @@
 /// </summary>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <numeric>
 #include <random>
+#include <set>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
 
 #include "LogSystem/LogSystem.h"
 #include "ThreadPool/ThreadPool.h"
+#include "ThreadPool/CoroutineTask.h"
+#include "ThreadPool/Pipeline.h"
+#include "ThreadPool/Strand.h"
+#include "ThreadPool/TaskFuture.h"
+#include "ThreadPool/TaskGraph.h"
+#include "ThreadPool/TaskGroup.h"
 
 /// <summary>
 /// 性能测试结果结构体
@@ -502,9 +511,12 @@ void TestIOBoundTasks()
         {
             auto taskStart = std::chrono::high_resolution_clock::now();
 
-            // 模拟随机IO操作
+            // 模拟随机IO操作，阻塞期间由补偿线程继续处理队列
             int sleepTime = IO_SIMULATION_TIME + (i % 10); // 添加一些随机性
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+            {
+                ScopedBlocking blocking;
+                std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+            }
 
             // 模拟一些轻量计算
             volatile int dummy = 0;
@@ -567,6 +579,7 @@ void TestIOBoundTasks()
     std::cout << "最大任务延迟: " << maxLatency << "ms" << std::endl;
     std::cout << "吞吐量: " << (completed * 1000.0 / duration.count()) << " 任务/秒" << std::endl;
     std::cout << "IO线程数: " << pool.GetCurrentThreadCount() << std::endl;
+    std::cout << "补偿线程创建次数: " << pool.GetStats().m_compensations << std::endl;
 
     pool.Shutdown();
 }
@@ -693,174 +706,1771 @@ void TestMixedPriorityTasks()
     std::cout << "吞吐量: " << (completed * 1000.0 / duration.count()) << " 任务/秒" << std::endl;
     std::cout << "\n各优先级任务统计:" << std::endl;
 
-    const char* priorityNames[] = {"Critical", "High", "Normal", "Low"};
+    // 下标与EM_TaskPriority的枚举值一致
+    const char* priorityNames[] = {"Low", "Normal", "High", "Critical"};
     for (int i = 0; i < 4; ++i)
     {
         if (priorityCount[i] > 0)
         {
-            std::cout << priorityNames[i] << "优先级:" << "\n  完成数量: " << priorityCount[i] << "\n  平均延迟: " << (priorityLatency[i] / priorityCount[i]) << "ms" << "\n  最大延迟: " << maxLatency[i] << "ms" << std::endl;
+            ST_PriorityWaitStats waitStats = pool.GetPriorityWaitStats(static_cast<EM_TaskPriority>(i));
+            std::cout << priorityNames[i] << "优先级:" << "\n  完成数量: " << priorityCount[i] << "\n  平均延迟: " << (priorityLatency[i] / priorityCount[i]) << "ms" << "\n  最大延迟: " << maxLatency[i] << "ms" << "\n  平均排队: " << waitStats.m_avgWaitUs / 1000.0 << "ms" << "\n  P99排队: " << waitStats.m_p99WaitUs / 1000.0 << "ms" << std::endl;
         }
     }
 
+    // 任务远多于线程，整个过程处于饱和状态；老化只占有限的出队机会，Critical的排队时间应始终低于Low
+    ST_PriorityWaitStats criticalWait = pool.GetPriorityWaitStats(EM_TaskPriority::Critical);
+    ST_PriorityWaitStats lowWait = pool.GetPriorityWaitStats(EM_TaskPriority::Low);
+    bool criticalFirst = criticalWait.m_avgWaitUs < lowWait.m_avgWaitUs && criticalWait.m_p99WaitUs < lowWait.m_p99WaitUs;
+    std::cout << "\n饱和时Critical排队低于Low: " << (criticalFirst ? "校验通过" : "校验失败") << std::endl;
+
     pool.Shutdown();
 }
 
 /// <summary>
-/// 生成随机日志消息
+/// 执行任务队列多生产者多消费者竞争测试
 /// </summary>
-/// <param name="length">消息长度</param>
-/// <returns>随机消息字符串</returns>
-std::string GenerateRandomMessage(size_t length)
+void TestQueueContention()
 {
-    static const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, sizeof(charset) - 2);
+    std::cout << "\n=== 任务队列竞争测试 ===\n" << std::endl;
 
-    std::string str(length, 0);
-    for (size_t i = 0; i < length; ++i)
+    const size_t OPS_PER_PRODUCER = 200000;
+    const size_t threadCounts[] = {1, 2, 4, 8, 16, 32};
+
+    for (size_t threadCount : threadCounts)
     {
-        str[i] = charset[dis(gen)];
+        LockFreeTaskQueue queue;
+        std::atomic<size_t> consumed{0};
+        std::atomic<uint64_t> checksum{0};
+        const size_t totalOps = OPS_PER_PRODUCER * threadCount;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < threadCount; ++p)
+        {
+            threads.emplace_back([&queue, &checksum, p]()
+            {
+                for (size_t i = 0; i < OPS_PER_PRODUCER; ++i)
+                {
+                    uint64_t value = p * OPS_PER_PRODUCER + i;
+                    ST_Task task;
+                    task.m_func = [&checksum, value]() { checksum.fetch_add(value, std::memory_order_relaxed); };
+                    task.m_priority = EM_TaskPriority::Normal;
+                    while (!queue.try_push(std::move(task)))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (size_t c = 0; c < threadCount; ++c)
+        {
+            threads.emplace_back([&queue, &consumed, totalOps]()
+            {
+                ST_Task task;
+                while (consumed.load(std::memory_order_relaxed) < totalOps)
+                {
+                    if (queue.try_pop(task))
+                    {
+                        task.m_func();
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+        // 所有值之和应为 0 + 1 + ... + (totalOps - 1)，丢失或重复都会导致校验失败
+        uint64_t expected = static_cast<uint64_t>(totalOps) * (totalOps - 1) / 2;
+        std::cout << threadCount << " 生产者 / " << threadCount << " 消费者: " << std::fixed << std::setprecision(2) << (totalOps / (duration.count() / 1000000.0)) << " 任务/秒" << (checksum.load() == expected ? " (校验通过)" : " (校验失败)") << std::endl;
     }
-    return str;
 }
 
 /// <summary>
-/// 日志系统压力测试类
+/// 递归拆分图像区域并处理，模拟分块渲染的分治任务
 /// </summary>
-class LogSystemStressTest
+/// <param name="pool">线程池实例</param>
+/// <param name="pixels">像素缓冲区</param>
+/// <param name="begin">起始像素</param>
+/// <param name="end">结束像素</param>
+/// <param name="tileSize">最小分块大小</param>
+/// <param name="remaining">剩余未处理的像素数</param>
+void ProcessTileRecursive(ThreadPool& pool, std::vector<float>& pixels, size_t begin, size_t end, size_t tileSize, std::atomic<size_t>& remaining)
 {
-public:
-    /// <summary>
-    /// 构造函数
-    /// </summary>
-    /// <param name="threadCount">测试线程数</param>
-    /// <param name="messageCount">每个线程的消息数</param>
-    /// <param name="messageSize">消息大小</param>
-    LogSystemStressTest(size_t threadCount, size_t messageCount, size_t messageSize)
-        : m_threadCount(threadCount), m_messageCount(messageCount), m_messageSize(messageSize)
+    if (end - begin > tileSize)
     {
-        // 配置线程池
-        ST_ThreadPoolConfig threadConfig;
-        threadConfig.m_minThreads = threadCount;
-        threadConfig.m_maxThreads = threadCount;
-        threadConfig.m_maxQueueSize = messageCount * threadCount;
-        threadConfig.m_keepAliveTime = 1000;
-        m_threadPool = std::make_unique<ThreadPool>(threadConfig);
+        size_t middle = begin + (end - begin) / 2;
+        pool.Submit([&pool, &pixels, middle, end, tileSize, &remaining]()
+        {
+            ProcessTileRecursive(pool, pixels, middle, end, tileSize, remaining);
+        });
+        ProcessTileRecursive(pool, pixels, begin, middle, tileSize, remaining);
+        return;
+    }
 
-        // 初始化日志系统
-        ST_LogConfig logConfig;
-        logConfig.m_logFilePath = "stress_test.log";
-        logConfig.m_logLevel = EM_LogLevel::Info;
-        logConfig.m_maxFileSize = 1024 * 1024 * 1024; // 1GB
-        logConfig.m_asyncEnabled = true;
-        LogSystem::Instance().Initialize(logConfig);
+    for (size_t i = begin; i < end; ++i)
+    {
+        pixels[i] = pixels[i] * 0.5f + 0.25f;
     }
+    remaining.fetch_sub(end - begin);
+}
 
-    /// <summary>
-    /// 运行压力测试
-    /// </summary>
-    void RunTest()
+/// <summary>
+/// 执行分治任务测试，对比全局队列与工作窃取两种调度模式
+/// </summary>
+void TestWorkStealingTasks()
+{
+    std::cout << "\n=== 分治任务调度模式测试 ===\n" << std::endl;
+
+    const size_t FRAME_PIXELS = 3840 * 2160;
+    const size_t TILE_SIZE = 4096;
+    const int FRAME_COUNT = 20;
+
+    const std::pair<EM_SchedulerMode, const char*> modes[] = {{EM_SchedulerMode::GlobalQueue, "全局队列"}, {EM_SchedulerMode::WorkStealing, "工作窃取"}};
+    for (const auto& [mode, modeName] : modes)
     {
-        std::cout << "Starting stress test with:" << std::endl << "Thread count: " << m_threadCount << std::endl << "Messages per thread: " << m_messageCount << std::endl << "Message size: " << m_messageSize << " bytes" << std::endl;
+        ST_ThreadPoolConfig config;
+        config.m_minThreads = std::thread::hardware_concurrency();
+        config.m_maxThreads = std::thread::hardware_concurrency();
+        config.m_schedulerMode = mode;
+        ThreadPool pool(config);
+        pool.EnableTracing();
 
-        auto startTime = std::chrono::high_resolution_clock::now();
-        std::vector<std::future<void>> futures;
+        std::vector<float> pixels(FRAME_PIXELS, 1.0f);
+        auto start = std::chrono::high_resolution_clock::now();
 
-        // 提交测试任务
-        for (size_t i = 0; i < m_threadCount; ++i)
+        for (int frame = 0; frame < FRAME_COUNT; ++frame)
         {
-            futures.push_back(m_threadPool->Submit([this, i]()
+            std::atomic<size_t> remaining{FRAME_PIXELS};
+            pool.Submit([&pool, &pixels, &remaining]()
             {
-                this->WriteLogsWorker(i);
-            }));
+                ProcessTileRecursive(pool, pixels, 0, FRAME_PIXELS, TILE_SIZE, remaining);
+            });
+
+            while (remaining.load() > 0)
+            {
+                std::this_thread::yield();
+            }
         }
 
-        // 等待所有任务完成
-        for (auto& future : futures)
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        std::cout << modeName << ": " << FRAME_COUNT << " 帧耗时 " << duration.count() << "ms" << std::endl;
+
+        // 导出执行时间线（写入内存，不产生文件），检查格式与任务事件数；写入文件后可在chrome://tracing或Perfetto中查看
+        std::ostringstream traceStream;
+        pool.WriteChromeTrace(traceStream);
+        std::string trace = traceStream.str();
+        size_t eventCount = 0;
+        for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1))
         {
-            future.wait();
+            ++eventCount;
         }
+        bool validHeader = trace.rfind("{\"traceEvents\"", 0) == 0;
+        std::cout << "执行轨迹: " << trace.size() << " 字节, 任务事件 " << eventCount
+                  << ((validHeader && eventCount > 0) ? " (格式正确)" : " (格式错误)") << std::endl;
 
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        pool.Shutdown();
+    }
+}
 
-        // 确保所有日志都被写入
-        LogSystem::Instance().Flush();
+/// <summary>
+/// 执行任务派发延迟测试，测量空闲线程池从提交到开始执行的耗时
+/// </summary>
+void TestDispatchLatency()
+{
+    std::cout << "\n=== 任务派发延迟测试 ===\n" << std::endl;
 
-        // 计算并显示统计信息
-        size_t totalMessages = m_threadCount * m_messageCount;
-        double totalSeconds = duration.count() / 1000.0;
-        double messagesPerSecond = totalMessages / totalSeconds;
-        double mbPerSecond = (totalMessages * m_messageSize) / (1024.0 * 1024.0 * totalSeconds);
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    ThreadPool pool(config);
 
-        std::cout << "\nTest completed:" << std::endl << "Total time: " << totalSeconds << " seconds" << std::endl << "Messages per second: " << messagesPerSecond << std::endl << "Throughput: " << mbPerSecond << " MB/s" << std::endl;
+    const int SAMPLE_COUNT = 1000;
+    std::vector<double> latencies;
+    latencies.reserve(SAMPLE_COUNT);
+
+    for (int i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        auto submitTime = std::chrono::steady_clock::now();
+        auto future = pool.Submit([submitTime]() -> double
+        {
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - submitTime).count();
+        });
+        latencies.push_back(future.get());
+
+        // 留出间隔让工作线程进入休眠，测量的是唤醒路径
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
 
-private:
-    /// <summary>
-    /// 工作线程函数
-    /// </summary>
-    /// <param name="threadId">线程ID</param>
-    void WriteLogsWorker(size_t threadId)
+    std::sort(latencies.begin(), latencies.end());
+    double total = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+    std::cout << std::fixed << std::setprecision(2) << "平均延迟: " << total / SAMPLE_COUNT << " us" << std::endl;
+    std::cout << "P50延迟: " << latencies[SAMPLE_COUNT / 2] << " us" << std::endl;
+    std::cout << "P99延迟: " << latencies[SAMPLE_COUNT * 99 / 100] << " us" << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行微小任务提交吞吐测试，对比Submit与Post
+/// </summary>
+void TestTinyTaskThroughput()
+{
+    std::cout << "\n=== 微小任务提交吞吐测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    ThreadPool pool(config);
+
+    const size_t TASK_COUNT = 1000000;
+    const size_t BATCH_SIZE = 8000;
+    std::atomic<size_t> counter{0};
+
+    // 分批提交，每批等待执行完毕，避免超过队列容量
+    auto runBatches = [&](auto&& submitOne)
     {
-        std::vector<EM_LogLevel> levels = {EM_LogLevel::Debug, EM_LogLevel::Info, EM_LogLevel::Warning, EM_LogLevel::Error, EM_LogLevel::Fatal};
+        counter = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < TASK_COUNT; i += BATCH_SIZE)
+        {
+            for (size_t j = 0; j < BATCH_SIZE; ++j)
+            {
+                submitOne();
+            }
+            while (counter.load() < i + BATCH_SIZE)
+            {
+                std::this_thread::yield();
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    };
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> levelDis(0, levels.size() - 1);
+    auto submitMs = runBatches([&]() { pool.Submit([&counter]() { counter.fetch_add(1); }); });
+    auto postMs = runBatches([&]() { pool.Post([&counter]() { counter.fetch_add(1); }); });
 
-        for (size_t i = 0; i < m_messageCount; ++i)
+    std::cout << "Submit: " << TASK_COUNT << " 任务耗时 " << submitMs << "ms" << std::endl;
+    std::cout << "Post: " << TASK_COUNT << " 任务耗时 " << postMs << "ms" << std::endl;
+
+    ST_ThreadPoolStats stats = pool.GetStats();
+    std::cout << "统计: 入队 " << stats.m_submitted << ", 完成 " << stats.m_completed << ", 窃取 " << stats.m_steals
+              << ", 休眠 " << stats.m_parks << ", 唤醒 " << stats.m_wakeups << std::endl;
+    std::cout << "排队等待: P50 " << stats.m_queueWait.m_p50Us << "us, P99 " << stats.m_queueWait.m_p99Us
+              << "us, P99.9 " << stats.m_queueWait.m_p999Us << "us, 最大 " << stats.m_queueWait.m_maxUs << "us" << std::endl;
+    std::cout << "执行时间: P50 " << stats.m_runTime.m_p50Us << "us, P99 " << stats.m_runTime.m_p99Us << "us" << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行任务续接测试，对比阻塞等待std::future与TaskFuture::Then链式续接
+/// </summary>
+void TestFutureContinuations()
+{
+    std::cout << "\n=== 任务续接测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    ThreadPool pool(config);
+
+    const int CHAIN_COUNT = 1000;
+    const int CHAIN_LENGTH = 8;
+
+    // 方式一：每一步都阻塞等待上一步结果再提交下一步
+    auto start = std::chrono::high_resolution_clock::now();
+    long long blockingSum = 0;
+    for (int i = 0; i < CHAIN_COUNT; ++i)
+    {
+        int value = i;
+        for (int step = 0; step < CHAIN_LENGTH; ++step)
         {
-            std::string message = GenerateRandomMessage(m_messageSize);
-            EM_LogLevel level = levels[levelDis(gen)];
-            LogSystem::Instance().WriteLog(level, QString::fromStdString("Thread-" + std::to_string(threadId) + ": " + message));
+            value = pool.Submit([value]() { return value + 1; }).get();
         }
+        blockingSum += value;
     }
+    auto blockingMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
 
-private:
-    size_t m_threadCount;                     ///< 测试线程数
-    size_t m_messageCount;                    ///< 每个线程的消息数
-    size_t m_messageSize;                     ///< 消息大小
-    std::unique_ptr<ThreadPool> m_threadPool; ///< 线程池
-};
+    // 方式二：用Then串联各步，用WhenAll汇总所有链的结果，提交线程只等待一次
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<TaskFuture<int>> chains;
+    chains.reserve(CHAIN_COUNT);
+    for (int i = 0; i < CHAIN_COUNT; ++i)
+    {
+        TaskFuture<int> future = pool.SubmitAsync([i]() { return i; });
+        for (int step = 0; step < CHAIN_LENGTH; ++step)
+        {
+            future = future.Then([](int value) { return value + 1; });
+        }
+        chains.push_back(std::move(future));
+    }
+    std::vector<int> results = WhenAll(std::move(chains)).Get();
+    long long continuationSum = std::accumulate(results.begin(), results.end(), 0LL);
+    auto continuationMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "阻塞等待: 结果 " << blockingSum << "，耗时 " << blockingMs << "ms" << std::endl;
+    std::cout << "Then续接: 结果 " << continuationSum << "，耗时 " << continuationMs << "ms" << std::endl;
+
+    pool.Shutdown();
+}
 
 /// <summary>
-/// 主函数
+/// 执行并行算法测试，对比逐元素Submit与ParallelFor/ParallelReduce/ParallelSort
 /// </summary>
-int main()
+void TestParallelAlgorithms()
 {
-    try
+    std::cout << "\n=== 并行算法测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = std::thread::hardware_concurrency();
+    config.m_maxThreads = std::thread::hardware_concurrency();
+    ThreadPool pool(config);
+
+    // 模拟音频缓冲区增益处理
+    const size_t SAMPLE_COUNT = 1 << 20;
+    std::vector<float> samples(SAMPLE_COUNT, 0.5f);
+
+    // 方式一：逐元素Submit并收集future，分批提交避免超过队列容量
+    auto start = std::chrono::high_resolution_clock::now();
+    const size_t BATCH_SIZE = 8192;
+    std::vector<std::future<void>> futures;
+    futures.reserve(BATCH_SIZE);
+    for (size_t batch = 0; batch < SAMPLE_COUNT; batch += BATCH_SIZE)
     {
-        // 创建压力测试实例
-        // 参数：8个线程，每个线程100000条消息，每条消息128字节
-        LogSystemStressTest test(8, 100000, 128);
-        test.RunTest();
-    } catch (const std::exception& e)
+        futures.clear();
+        for (size_t i = batch; i < batch + BATCH_SIZE; ++i)
+        {
+            futures.push_back(pool.Submit([&samples, i]() { samples[i] *= 1.01f; }));
+        }
+        for (auto& future : futures)
+        {
+            future.wait();
+        }
+    }
+    auto submitMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // 方式二：ParallelFor按粒度拆分区间，调用线程参与执行
+    start = std::chrono::high_resolution_clock::now();
+    pool.ParallelFor(size_t(0), SAMPLE_COUNT, [&samples](size_t i) { samples[i] *= 1.01f; });
+    auto parallelForUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // 求峰值电平
+    start = std::chrono::high_resolution_clock::now();
+    float peak = pool.ParallelReduce(size_t(0), SAMPLE_COUNT, 0, 0.0f,
+        [&samples](size_t i) { return std::abs(samples[i]); },
+        [](float a, float b) { return std::max(a, b); });
+    auto reduceUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // 排序
+    std::vector<uint32_t> keys(SAMPLE_COUNT);
+    std::mt19937 gen(42);
+    for (auto& key : keys)
     {
-        std::cerr << "Error: " << e.what() << std::endl;
-        return 1;
+        key = gen();
     }
+    start = std::chrono::high_resolution_clock::now();
+    pool.ParallelSort(keys.begin(), keys.end());
+    auto sortMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
 
-    return 0;
-    try
+    std::cout << "逐元素Submit: " << SAMPLE_COUNT << " 元素耗时 " << submitMs << "ms" << std::endl;
+    std::cout << "ParallelFor: " << SAMPLE_COUNT << " 元素耗时 " << parallelForUs << "us" << std::endl;
+    std::cout << "ParallelReduce: 峰值 " << peak << "，耗时 " << reduceUs << "us" << std::endl;
+    std::cout << "ParallelSort: " << SAMPLE_COUNT << " 元素耗时 " << sortMs << "ms，结果"
+              << (std::is_sorted(keys.begin(), keys.end()) ? "有序" : "无序") << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行任务依赖图测试，模拟多路媒体流的解复用、解码、滤镜、编码流水
+/// 每路流的阶段依赖由任务图保证，线程数少于流数时也不会因阻塞等待前驱而死锁
+/// </summary>
+void TestTaskGraph()
+{
+    std::cout << "\n=== 任务依赖图测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 2;
+    config.m_maxThreads = 2;
+    ThreadPool pool(config);
+
+    const size_t STREAM_COUNT = 8;
+    const int RUN_COUNT = 100;
+    auto work = [](int iterations)
     {
-        std::cout << "=== 开始线程池性能测试 ===" << std::endl;
+        volatile double value = 0.0;
+        for (int i = 0; i < iterations; ++i)
+        {
+            value = value + std::sqrt(static_cast<double>(i));
+        }
+    };
 
-        // 执行计算密集型任务测试
-        TestComputeBoundTasks();
+    TaskGraph graph(pool);
+    std::atomic<size_t> encodedCount{0};
+    for (size_t stream = 0; stream < STREAM_COUNT; ++stream)
+    {
+        auto demux = graph.AddNode([&work]() { work(2000); });
+        auto decode = graph.AddNode([&work]() { work(20000); }, EM_TaskPriority::High);
+        auto filterVideo = graph.AddNode([&work]() { work(10000); });
+        auto filterAudio = graph.AddNode([&work]() { work(5000); });
+        auto encode = graph.AddNode([&work, &encodedCount]()
+        {
+            work(20000);
+            encodedCount.fetch_add(1);
+        });
 
-        // 等待一段时间
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        graph.AddEdge(demux, decode);
+        graph.AddEdge(decode, filterVideo);
+        graph.AddEdge(decode, filterAudio);
+        graph.AddEdge(filterVideo, encode);
+        graph.AddEdge(filterAudio, encode);
+    }
 
-        // 执行IO密集型任务测试
-        TestIOBoundTasks();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int run = 0; run < RUN_COUNT; ++run)
+    {
+        graph.Run().Get();
+    }
+    auto durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
 
-        // 等待一段时间
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+    std::cout << "节点数: " << graph.GetNodeCount() << "，运行次数: " << RUN_COUNT << std::endl;
+    std::cout << "完成编码: " << encodedCount.load() << "，总耗时 " << durationMs << "ms" << std::endl;
 
-        // 执行混合优先级任务测试
-        TestMixedPriorityTasks();
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 模拟异步IO设备：请求在后台线程上延迟完成，完成时才设置future结果
+/// </summary>
+class SimulatedIoDevice
+{
+public:
+    explicit SimulatedIoDevice(ThreadPool& pool)
+        : m_pool(pool)
+        , m_thread([this]() { Run(); })
+    {
+    }
+
+    ~SimulatedIoDevice()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_thread.join();
+    }
+
+    /// <summary>
+    /// 发起读请求，约10毫秒后完成
+    /// </summary>
+    TaskFuture<int> Read(int value)
+    {
+        TaskPromise<int> promise(&m_pool);
+        TaskFuture<int> future = promise.GetFuture();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.emplace_back(std::move(promise), value);
+        return future;
+    }
+
+private:
+    void Run()
+    {
+        while (true)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::vector<std::pair<TaskPromise<int>, int>> completed;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                completed.swap(m_pending);
+                if (m_stop && completed.empty())
+                {
+                    return;
+                }
+            }
+            for (auto& request : completed)
+            {
+                request.first.SetValue(request.second);
+            }
+        }
+    }
+
+private:
+    ThreadPool& m_pool;
+    std::mutex m_mutex;
+    std::vector<std::pair<TaskPromise<int>, int>> m_pending;
+    bool m_stop{false};
+    std::thread m_thread;
+};
+
+/// <summary>
+/// 单个逻辑作业：切换到线程池，交替进行计算与异步IO，等待IO期间不占用工作线程
+/// </summary>
+CoTask<int> RunCoroutineJob(ThreadPool& pool, SimulatedIoDevice& device, int id)
+{
+    co_await pool.Schedule();
+    int total = 0;
+    for (int step = 0; step < 3; ++step)
+    {
+        total += co_await device.Read(id + step);
+    }
+    co_return total;
+}
+
+/// <summary>
+/// 执行协程测试，在少量工作线程上运行大量需要等待IO的逻辑作业
+/// </summary>
+void TestCoroutines()
+{
+    std::cout << "\n=== 协程调度测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = std::thread::hardware_concurrency();
+    config.m_maxThreads = std::thread::hardware_concurrency();
+    ThreadPool pool(config);
+    SimulatedIoDevice device(pool);
+
+    const int JOB_COUNT = 10000;
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<TaskFuture<int>> jobs;
+    jobs.reserve(JOB_COUNT);
+    for (int i = 0; i < JOB_COUNT; ++i)
+    {
+        jobs.push_back(ToTaskFuture(RunCoroutineJob(pool, device, i), &pool));
+    }
+    std::vector<int> results = WhenAll(std::move(jobs)).Get();
+    auto durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+    long long sum = std::accumulate(results.begin(), results.end(), 0LL);
+    std::cout << "工作线程数: " << pool.GetCurrentThreadCount() << "，并发作业数: " << JOB_COUNT << std::endl;
+    std::cout << "结果校验和: " << sum << "，总耗时 " << durationMs << "ms（每个作业串行等待3次10ms的IO）" << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行批量等待测试，分批提交小任务并等待每批完成，对比WaitAll与TaskGroup
+/// </summary>
+void TestBatchWait()
+{
+    std::cout << "\n=== 批量等待测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    ThreadPool pool(config);
+
+    const int BATCH_COUNT = 200;
+    const int TASKS_PER_BATCH = 64;
+    std::atomic<int> counter{0};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int batch = 0; batch < BATCH_COUNT; ++batch)
+    {
+        for (int i = 0; i < TASKS_PER_BATCH; ++i)
+        {
+            pool.Post([&counter]() { counter.fetch_add(1); });
+        }
+        pool.WaitAll();
+    }
+    auto waitAllMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (int batch = 0; batch < BATCH_COUNT; ++batch)
+    {
+        TaskGroup group(pool);
+        for (int i = 0; i < TASKS_PER_BATCH; ++i)
+        {
+            group.Run([&counter]() { counter.fetch_add(1); });
+        }
+        group.Wait();
+    }
+    auto groupMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start).count();
+
+    std::cout << "WaitAll: " << BATCH_COUNT << " 批耗时 " << waitAllMs << "ms" << std::endl;
+    std::cout << "TaskGroup: " << BATCH_COUNT << " 批耗时 " << groupMs << "ms" << std::endl;
+    std::cout << "执行任务数: " << counter.load() << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行定时任务测试，大量延迟任务与周期任务共用一个定时线程
+/// </summary>
+void TestTimers()
+{
+    std::cout << "\n=== 定时任务测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    ThreadPool pool(config);
+
+    const int TIMER_COUNT = 200000;
+    std::atomic<int> firedCount{0};
+    std::atomic<int64_t> totalLatenessUs{0};
+
+    // 模拟大量请求超时：一半在到期前取消
+    auto start = std::chrono::steady_clock::now();
+    std::vector<TimerId> timers;
+    timers.reserve(TIMER_COUNT);
+    for (int i = 0; i < TIMER_COUNT; ++i)
+    {
+        auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(200 + i % 800);
+        timers.push_back(pool.SubmitAt(due, [due, &firedCount, &totalLatenessUs]()
+        {
+            totalLatenessUs.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - due).count());
+            firedCount.fetch_add(1);
+        }));
+    }
+    auto insertMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    int cancelledCount = 0;
+    for (int i = 0; i < TIMER_COUNT; i += 2)
+    {
+        cancelledCount += pool.CancelTimer(timers[i]) ? 1 : 0;
+    }
+
+    // 模拟统计刷新
+    std::atomic<int> flushCount{0};
+    TimerId flushTimer = pool.SubmitEvery(std::chrono::milliseconds(100), [&flushCount]() { flushCount.fetch_add(1); });
+
+    while (firedCount.load() + cancelledCount < TIMER_COUNT)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    pool.CancelTimer(flushTimer);
+
+    std::cout << "插入 " << TIMER_COUNT << " 个定时器耗时 " << insertMs << "ms，取消 " << cancelledCount << " 个" << std::endl;
+    std::cout << "触发 " << firedCount.load() << " 个，平均延后 " << totalLatenessUs.load() / std::max(1, firedCount.load()) << " us" << std::endl;
+    std::cout << "周期刷新次数: " << flushCount.load() << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 生成随机日志消息
+/// </summary>
+/// <param name="length">消息长度</param>
+/// <returns>随机消息字符串</returns>
+std::string GenerateRandomMessage(size_t length)
+{
+    static const char charset[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    static std::random_device rd;
+    static std::mt19937 gen(rd());
+    static std::uniform_int_distribution<> dis(0, sizeof(charset) - 2);
+
+    std::string str(length, 0);
+    for (size_t i = 0; i < length; ++i)
+    {
+        str[i] = charset[dis(gen)];
+    }
+    return str;
+}
+
+/// <summary>
+/// 日志系统压力测试类
+/// </summary>
+class LogSystemStressTest
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="threadCount">测试线程数</param>
+    /// <param name="messageCount">每个线程的消息数</param>
+    /// <param name="messageSize">消息大小</param>
+    LogSystemStressTest(size_t threadCount, size_t messageCount, size_t messageSize)
+        : m_threadCount(threadCount), m_messageCount(messageCount), m_messageSize(messageSize)
+    {
+        // 配置线程池
+        ST_ThreadPoolConfig threadConfig;
+        threadConfig.m_minThreads = threadCount;
+        threadConfig.m_maxThreads = threadCount;
+        threadConfig.m_maxQueueSize = messageCount * threadCount;
+        threadConfig.m_keepAliveTime = 1000;
+        m_threadPool = std::make_unique<ThreadPool>(threadConfig);
+
+        // 初始化日志系统
+        ST_LogConfig logConfig;
+        logConfig.m_logFilePath = "stress_test.log";
+        logConfig.m_logLevel = EM_LogLevel::Info;
+        logConfig.m_maxFileSize = 1024 * 1024 * 1024; // 1GB
+        logConfig.m_asyncEnabled = true;
+        LogSystem::Instance().Initialize(logConfig);
+    }
+
+    /// <summary>
+    /// 运行压力测试
+    /// </summary>
+    void RunTest()
+    {
+        std::cout << "Starting stress test with:" << std::endl << "Thread count: " << m_threadCount << std::endl << "Messages per thread: " << m_messageCount << std::endl << "Message size: " << m_messageSize << " bytes" << std::endl;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        std::vector<std::future<void>> futures;
+
+        // 提交测试任务
+        for (size_t i = 0; i < m_threadCount; ++i)
+        {
+            futures.push_back(m_threadPool->Submit([this, i]()
+            {
+                this->WriteLogsWorker(i);
+            }));
+        }
+
+        // 等待所有任务完成
+        for (auto& future : futures)
+        {
+            future.wait();
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+
+        // 确保所有日志都被写入
+        LogSystem::Instance().Flush();
+
+        // 计算并显示统计信息
+        size_t totalMessages = m_threadCount * m_messageCount;
+        double totalSeconds = duration.count() / 1000.0;
+        double messagesPerSecond = totalMessages / totalSeconds;
+        double mbPerSecond = (totalMessages * m_messageSize) / (1024.0 * 1024.0 * totalSeconds);
+
+        std::cout << "\nTest completed:" << std::endl << "Total time: " << totalSeconds << " seconds" << std::endl << "Messages per second: " << messagesPerSecond << std::endl << "Throughput: " << mbPerSecond << " MB/s" << std::endl;
+    }
+
+private:
+    /// <summary>
+    /// 工作线程函数
+    /// </summary>
+    /// <param name="threadId">线程ID</param>
+    void WriteLogsWorker(size_t threadId)
+    {
+        std::vector<EM_LogLevel> levels = {EM_LogLevel::Debug, EM_LogLevel::Info, EM_LogLevel::Warning, EM_LogLevel::Error, EM_LogLevel::Fatal};
+
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<> levelDis(0, levels.size() - 1);
+
+        for (size_t i = 0; i < m_messageCount; ++i)
+        {
+            std::string message = GenerateRandomMessage(m_messageSize);
+            EM_LogLevel level = levels[levelDis(gen)];
+            LogSystem::Instance().WriteLog(level, QString::fromStdString("Thread-" + std::to_string(threadId) + ": " + message));
+        }
+    }
+
+private:
+    size_t m_threadCount;                     ///< 测试线程数
+    size_t m_messageCount;                    ///< 每个线程的消息数
+    size_t m_messageSize;                     ///< 消息大小
+    std::unique_ptr<ThreadPool> m_threadPool; ///< 线程池
+};
+
+/// <summary>
+/// 执行过载策略测试，单个工作线程被占住时突发提交，对比各策略的处理结果
+/// </summary>
+void TestOverloadPolicies()
+{
+    std::cout << "\n=== 过载策略测试 ===\n" << std::endl;
+
+    const char* policyNames[] = { "Throw", "Block", "CallerRuns", "DropOldestLowest", "Reject" };
+    const EM_OverloadPolicy policies[] = {
+        EM_OverloadPolicy::Throw, EM_OverloadPolicy::Block, EM_OverloadPolicy::CallerRuns,
+        EM_OverloadPolicy::DropOldestLowest, EM_OverloadPolicy::Reject
+    };
+    const int BURST_SIZE = 5000;
+
+    for (size_t p = 0; p < 5; ++p)
+    {
+        ST_ThreadPoolConfig config;
+        config.m_minThreads = 1;
+        config.m_maxThreads = 1;
+        config.m_maxQueueSize = 1000;
+        config.m_overloadPolicy = policies[p];
+        config.m_overloadTimeout = 100;
+        ThreadPool pool(config);
+
+        // 先占住唯一的工作线程，使队列很快被填满
+        std::atomic<bool> released{false};
+        pool.Post([&released]()
+        {
+            while (!released.load())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        std::thread releaser([&released]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            released.store(true);
+        });
+
+        std::atomic<int> executedCount{0};
+        int exceptionCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BURST_SIZE; ++i)
+        {
+            EM_TaskPriority priority = (i % 10 == 0) ? EM_TaskPriority::High : EM_TaskPriority::Low;
+            try
+            {
+                pool.Post([&executedCount]() { executedCount.fetch_add(1); }, priority);
+            }
+            catch (const std::exception&)
+            {
+                ++exceptionCount;
+            }
+        }
+        auto submitMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        releaser.join();
+        pool.WaitAll();
+
+        ST_OverloadStats stats = pool.GetOverloadStats();
+        std::cout << policyNames[p] << ": 提交耗时 " << submitMs << "ms, 执行 " << executedCount.load()
+                  << ", 异常 " << exceptionCount << ", 拒绝 " << stats.m_rejected << ", 挤出 " << stats.m_dropped
+                  << ", 调用者执行 " << stats.m_callerRuns << ", 阻塞 " << stats.m_blocked << std::endl;
+
+        pool.Shutdown();
+    }
+}
+
+/// <summary>
+/// 执行自适应线程数测试，突发的阻塞型任务与计算型任务交替出现，观察线程数的增长与回落
+/// </summary>
+void TestAdaptiveSizing()
+{
+    std::cout << "\n=== 自适应线程数测试 ===\n" << std::endl;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 2;
+    config.m_maxThreads = 64;
+    config.m_keepAliveTime = 500;
+    config.m_maxQueueSize = 100000;
+    ThreadPool pool(config);
+
+    const int BURST_COUNT = 3;
+    const int IO_TASK_COUNT = 2000;
+    const int CPU_TASK_COUNT = 2000;
+    std::atomic<int> completedCount{0};
+
+    auto runBurst = [&](const char* name, int taskCount, auto&& taskBody)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < taskCount; ++i)
+        {
+            pool.Post([&completedCount, &taskBody]()
+            {
+                taskBody();
+                completedCount.fetch_add(1);
+            });
+        }
+
+        size_t peakThreads = pool.GetCurrentThreadCount();
+        while (pool.GetTaskCount() > 0)
+        {
+            peakThreads = std::max(peakThreads, pool.GetCurrentThreadCount());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        pool.WaitAll();
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << taskCount << " 任务耗时 " << elapsedMs << "ms, 峰值线程数 " << peakThreads << std::endl;
+    };
+
+    auto ioBody = []() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); };
+    auto cpuBody = []()
+    {
+        volatile double value = 0;
+        for (int k = 0; k < 200000; ++k)
+        {
+            value = value + std::sqrt(static_cast<double>(k));
+        }
+    };
+
+    for (int burst = 0; burst < BURST_COUNT; ++burst)
+    {
+        runBurst("阻塞型突发", IO_TASK_COUNT, ioBody);
+        runBurst("计算型突发", CPU_TASK_COUNT, cpuBody);
+
+        // 空闲超过保持时间后多余线程退出
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        std::cout << "空闲后线程数: " << pool.GetCurrentThreadCount() << " (硬件线程数 " << std::thread::hardware_concurrency() << ")" << std::endl;
+    }
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行串行执行器测试，模拟多路RTP会话的包处理：同一会话内必须按序号顺序处理，不同会话之间并行
+/// 对比每个会话一把互斥锁（工作线程在锁上阻塞）与SerialExecutor（工作线程无锁）
+/// </summary>
+void TestStrands()
+{
+    std::cout << "\n=== 串行执行器测试 ===\n" << std::endl;
+
+    const int SESSION_COUNT = 64;
+    const int PACKETS_PER_SESSION = 5000;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    config.m_maxQueueSize = SESSION_COUNT * PACKETS_PER_SESSION;
+    ThreadPool pool(config);
+
+    // 模拟解码一个包的计算量
+    auto processPacket = [](uint64_t& state, int sequence)
+    {
+        for (int i = 0; i < 200; ++i)
+        {
+            state = state * 6364136223846793005ULL + static_cast<uint64_t>(sequence);
+        }
+    };
+
+    // 方式一：每个会话一把互斥锁，同一会话的包可能被多个工作线程同时取到而互相阻塞，且无法保证顺序
+    {
+        std::vector<std::mutex> sessionMutexes(SESSION_COUNT);
+        std::vector<uint64_t> sessionState(SESSION_COUNT, 0);
+        std::vector<int> lastSequence(SESSION_COUNT, -1);
+        std::atomic<int> outOfOrder{0};
+
+        auto start = std::chrono::steady_clock::now();
+        for (int sequence = 0; sequence < PACKETS_PER_SESSION; ++sequence)
+        {
+            for (int session = 0; session < SESSION_COUNT; ++session)
+            {
+                pool.Post([&, session, sequence]()
+                {
+                    std::lock_guard<std::mutex> lock(sessionMutexes[session]);
+                    if (lastSequence[session] > sequence)
+                    {
+                        outOfOrder.fetch_add(1);
+                    }
+                    lastSequence[session] = sequence;
+                    processPacket(sessionState[session], sequence);
+                });
+            }
+        }
+        pool.WaitAll();
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "互斥锁: " << SESSION_COUNT * PACKETS_PER_SESSION << " 个包耗时 " << elapsedMs << "ms, 乱序 " << outOfOrder.load() << std::endl;
+    }
+
+    // 方式二：按会话键串行执行，同一会话严格按提交顺序处理
+    {
+        SerialExecutor executor(pool);
+        std::vector<uint64_t> sessionState(SESSION_COUNT, 0);
+        std::vector<int> lastSequence(SESSION_COUNT, -1);
+        std::atomic<int> outOfOrder{0};
+        std::atomic<int> processedCount{0};
+
+        auto start = std::chrono::steady_clock::now();
+        for (int sequence = 0; sequence < PACKETS_PER_SESSION; ++sequence)
+        {
+            for (int session = 0; session < SESSION_COUNT; ++session)
+            {
+                executor.Post(session, [&, session, sequence]()
+                {
+                    if (lastSequence[session] != sequence - 1)
+                    {
+                        outOfOrder.fetch_add(1);
+                    }
+                    lastSequence[session] = sequence;
+                    processPacket(sessionState[session], sequence);
+                    processedCount.fetch_add(1);
+                });
+            }
+        }
+        while (processedCount.load() < SESSION_COUNT * PACKETS_PER_SESSION)
+        {
+            pool.WaitAll();
+        }
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "SerialExecutor: " << SESSION_COUNT * PACKETS_PER_SESSION << " 个包耗时 " << elapsedMs << "ms, 乱序 " << outOfOrder.load() << std::endl;
+    }
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行专用线程测试，模拟音频采集循环：线程池被大量计算任务占满时，对比投递到线程池与投递到专用线程邮箱的帧处理延迟
+/// </summary>
+void TestDedicatedThreads()
+{
+    std::cout << "\n=== 专用线程测试 ===\n" << std::endl;
+
+    const int FRAME_COUNT = 500;
+    const int BULK_TASK_COUNT = 4000;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    ThreadPool pool(config);
+
+    // 绑定到最后一个核心，避免与其他线程争抢
+    int captureCore = static_cast<int>((std::max)(std::thread::hardware_concurrency(), 1u)) - 1;
+    size_t captureThread = pool.CreateDedicatedThread("AudioCapture", []()
+    {
+        std::cout << "音频采集线程初始化完成" << std::endl;
+    }, captureCore);
+
+    // 模拟批量计算任务
+    auto postBulkWork = [&pool]()
+    {
+        for (int i = 0; i < BULK_TASK_COUNT; ++i)
+        {
+            pool.Post([]()
+            {
+                volatile uint64_t state = 0;
+                for (int j = 0; j < 200000; ++j)
+                {
+                    state = state * 6364136223846793005ULL + j;
+                }
+            }, EM_TaskPriority::Low);
+        }
+    };
+
+    // 每毫秒产生一帧，记录从投递到开始处理的延迟
+    auto runFrames = [](const std::function<void(std::function<void()>)>& post)
+    {
+        std::vector<int64_t> latencies(FRAME_COUNT, 0);
+        std::atomic<int> processedCount{0};
+        for (int frame = 0; frame < FRAME_COUNT; ++frame)
+        {
+            auto postTime = std::chrono::steady_clock::now();
+            post([&latencies, &processedCount, frame, postTime]()
+            {
+                latencies[frame] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - postTime).count();
+                processedCount.fetch_add(1);
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        while (processedCount.load() < FRAME_COUNT)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << "p50 " << latencies[FRAME_COUNT / 2] << "us, p99 " << latencies[FRAME_COUNT * 99 / 100]
+                  << "us, 最大 " << latencies.back() << "us" << std::endl;
+    };
+
+    postBulkWork();
+    std::cout << "帧投递到线程池(Critical优先级): ";
+    runFrames([&pool](std::function<void()> frameTask)
+    {
+        pool.Post(std::move(frameTask), EM_TaskPriority::Critical);
+    });
+    pool.WaitAll();
+
+    postBulkWork();
+    std::cout << "帧投递到专用线程邮箱: ";
+    runFrames([&pool, captureThread](std::function<void()> frameTask)
+    {
+        pool.PostToDedicatedThread(captureThread, std::move(frameTask));
+    });
+
+    auto frameCount = pool.SubmitToDedicatedThread(captureThread, []() { return 42; });
+    std::cout << "专用线程返回值: " << frameCount.get() << std::endl;
+    pool.WaitAll();
+
+    for (const ST_DedicatedThreadStatus& status : pool.GetAllDedicatedThreads())
+    {
+        std::cout << "专用线程 " << status.m_threadId << " [" << status.m_name << "] 核心 " << status.m_cpuCore
+                  << ", 已执行 " << status.m_executedCount << ", 待执行 " << status.m_pendingCount << std::endl;
+    }
+
+    pool.StopDedicatedThread(captureThread);
+    std::cout << "停止后投递: " << (pool.PostToDedicatedThread(captureThread, []() {}) ? "成功" : "失败") << std::endl;
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行工作线程放置测试：按NUMA节点划分工作线程并命名，对比处理大帧缓冲时与自由调度的耗时
+/// </summary>
+void TestWorkerPlacement()
+{
+    std::cout << "\n=== 工作线程放置测试 ===\n" << std::endl;
+
+    const int FRAME_COUNT = 64;
+    const size_t FRAME_SIZE = 4 * 1024 * 1024;
+    const int PASSES = 8;
+
+    auto runFrames = [&](const ST_ThreadPoolConfig& config, const char* label)
+    {
+        ThreadPool pool(config);
+        std::vector<std::vector<uint8_t>> frames(FRAME_COUNT);
+
+        // 帧缓冲由执行任务的线程首次写入，按首次访问策略分配在该线程所在节点的内存上
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            for (int frame = 0; frame < FRAME_COUNT; ++frame)
+            {
+                pool.Post([&frames, frame, pass]()
+                {
+                    std::vector<uint8_t>& buffer = frames[frame];
+                    if (buffer.empty())
+                    {
+                        buffer.resize(FRAME_SIZE);
+                    }
+                    for (size_t i = 0; i < buffer.size(); i += 64)
+                    {
+                        buffer[i] = static_cast<uint8_t>(buffer[i] + pass);
+                    }
+                });
+            }
+            pool.WaitAll();
+        }
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << label << ": 分区数 " << pool.GetNodeCount() << ", 耗时 " << elapsedMs << "ms" << std::endl;
+        pool.Shutdown();
+    };
+
+    ST_ThreadPoolConfig freeConfig;
+    freeConfig.m_minThreads = (std::max)(std::thread::hardware_concurrency(), 2u);
+    freeConfig.m_maxThreads = freeConfig.m_minThreads;
+    runFrames(freeConfig, "自由调度");
+
+    ST_ThreadPoolConfig numaConfig = freeConfig;
+    numaConfig.m_numaAware = true;
+    numaConfig.m_threadNamePrefix = "Encoder";
+    runFrames(numaConfig, "按NUMA节点划分(线程名Encoder-N)");
+}
+
+/// <summary>
+/// 执行取消与截止时间测试，模拟过载时观众中途离开：已离开观众的帧与超过截止时间的帧在出队时直接跳过，不占用工作线程
+/// </summary>
+void TestCancellation()
+{
+    std::cout << "\n=== 任务取消测试 ===\n" << std::endl;
+
+    const int VIEWER_COUNT = 8;
+    const int FRAMES_PER_VIEWER = 200;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 2;
+    config.m_maxThreads = 2;
+    ThreadPool pool(config);
+
+    // 模拟编码一帧约1毫秒
+    auto encodeFrame = [](int frame)
+    {
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+        while (std::chrono::steady_clock::now() < end) {}
+        return frame;
+    };
+
+    std::vector<CancellationSource> viewers(VIEWER_COUNT);
+    std::vector<std::future<int>> results;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < FRAMES_PER_VIEWER; ++frame)
+    {
+        for (int viewer = 0; viewer < VIEWER_COUNT; ++viewer)
+        {
+            results.push_back(pool.Submit([encodeFrame, frame]() { return encodeFrame(frame); }, viewers[viewer].GetToken(), deadline));
+        }
+    }
+
+    // 一半观众很快离开
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int viewer = 0; viewer < VIEWER_COUNT / 2; ++viewer)
+    {
+        viewers[viewer].Cancel();
+    }
+
+    int completedCount = 0;
+    int cancelledCount = 0;
+    for (auto& result : results)
+    {
+        try
+        {
+            result.get();
+            ++completedCount;
+        }
+        catch (const TaskCancelledException&)
+        {
+            ++cancelledCount;
+        }
+    }
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    ST_ThreadPoolStats stats = pool.GetStats();
+    std::cout << "提交 " << results.size() << " 帧, 编码 " << completedCount << " 帧, 取消 " << cancelledCount
+              << " 帧 (线程池统计跳过 " << stats.m_cancelled << " 帧), 耗时 " << elapsedMs << "ms" << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行阻塞补偿测试：计算任务与会阻塞的IO任务混合提交，对比普通提交与SubmitBlocking下计算任务的完成时间
+/// </summary>
+void TestBlockingCompensation()
+{
+    std::cout << "\n=== 阻塞补偿测试 ===\n" << std::endl;
+
+    const int IO_TASK_COUNT = 32;
+    const int CPU_TASK_COUNT = 200;
+
+    auto runMixed = [](bool markBlocking)
+    {
+        ST_ThreadPoolConfig config;
+        config.m_minThreads = 4;
+        config.m_maxThreads = 4;
+        ThreadPool pool(config);
+
+        // 模拟读取磁盘或管道
+        auto readPipe = []()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        };
+        auto compute = []()
+        {
+            volatile uint64_t state = 0;
+            for (int i = 0; i < 100000; ++i)
+            {
+                state = state * 6364136223846793005ULL + i;
+            }
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<void>> ioResults;
+        std::vector<std::future<void>> cpuResults;
+        for (int i = 0; i < IO_TASK_COUNT; ++i)
+        {
+            ioResults.push_back(markBlocking ? pool.SubmitBlocking(readPipe) : pool.Submit(readPipe));
+        }
+        for (int i = 0; i < CPU_TASK_COUNT; ++i)
+        {
+            cpuResults.push_back(pool.Submit(compute));
+        }
+
+        for (auto& result : cpuResults)
+        {
+            result.get();
+        }
+        auto cpuMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        for (auto& result : ioResults)
+        {
+            result.get();
+        }
+        auto totalMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        ST_ThreadPoolStats stats = pool.GetStats();
+        std::cout << (markBlocking ? "SubmitBlocking" : "普通提交") << ": 计算任务完成 " << cpuMs << "ms, 全部完成 " << totalMs
+                  << "ms, 补偿线程 " << stats.m_compensations << " 次" << std::endl;
+        pool.Shutdown();
+    };
+
+    runMixed(false);
+    runMixed(true);
+}
+
+/// <summary>
+/// 执行分片提交测试：生产者线程数从4增加到1024，对比不分片与16个提交分片时每次提交的平均耗时
+/// </summary>
+void TestShardedSubmission()
+{
+    std::cout << "\n=== 分片提交测试 ===\n" << std::endl;
+
+    const int TOTAL_TASKS = 200000;
+
+    for (size_t shards : { static_cast<size_t>(1), static_cast<size_t>(16) })
+    {
+        ST_ThreadPoolConfig config;
+        config.m_minThreads = 4;
+        config.m_maxThreads = 4;
+        config.m_maxQueueSize = TOTAL_TASKS;
+        config.m_submitShards = shards;
+        ThreadPool pool(config);
+
+        std::atomic<int> completed{0};
+        for (int producers = 4; producers <= 1024; producers *= 4)
+        {
+            const int tasksPerProducer = TOTAL_TASKS / producers;
+            std::atomic<int64_t> submitNanos{0};
+
+            std::vector<std::thread> threads;
+            for (int p = 0; p < producers; ++p)
+            {
+                threads.emplace_back([&pool, &completed, &submitNanos, tasksPerProducer]()
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    for (int i = 0; i < tasksPerProducer; ++i)
+                    {
+                        pool.Post([&completed]() { completed.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                    auto elapsed = std::chrono::steady_clock::now() - start;
+                    submitNanos.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+                });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            pool.WaitAll();
+
+            std::cout << (shards == 1 ? "不分片" : "分片") << ", 生产者 " << producers << ": 平均每次提交 "
+                      << submitNanos.load() / (static_cast<int64_t>(tasksPerProducer) * producers) << "ns" << std::endl;
+        }
+        std::cout << "完成任务数: " << completed.load() << std::endl;
+        pool.Shutdown();
+    }
+}
+
+/// <summary>
+/// 执行线程亲和测试：每个数据流持有一块较大的状态缓冲，对比普通提交与按流SubmitNear提交的耗时，并检查同一流是否始终由同一线程处理
+/// </summary>
+void TestWorkerAffinity()
+{
+    std::cout << "\n=== 线程亲和测试 ===\n" << std::endl;
+
+    const int STREAM_COUNT = 8;
+    const int CHUNKS_PER_STREAM = 500;
+    const size_t STATE_SIZE = 256 * 1024 / sizeof(uint64_t); // 每个流256KB状态
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    config.m_maxQueueSize = STREAM_COUNT * CHUNKS_PER_STREAM;
+    ThreadPool pool(config);
+
+    std::vector<std::vector<uint64_t>> streamStates(STREAM_COUNT, std::vector<uint64_t>(STATE_SIZE, 1));
+    std::vector<std::mutex> streamMutexes(STREAM_COUNT);
+
+    auto processChunk = [&streamStates, &streamMutexes](int stream)
+    {
+        std::lock_guard<std::mutex> lock(streamMutexes[stream]);
+        uint64_t carry = 0;
+        for (uint64_t& value : streamStates[stream])
+        {
+            value = value * 31 + carry;
+            carry = value >> 60;
+        }
+    };
+
+    for (bool nearStream : { false, true })
+    {
+        std::vector<std::set<size_t>> workersPerStream(STREAM_COUNT);
+        std::mutex workersMutex;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<void>> results;
+        for (int chunk = 0; chunk < CHUNKS_PER_STREAM; ++chunk)
+        {
+            for (int stream = 0; stream < STREAM_COUNT; ++stream)
+            {
+                auto work = [&, stream]()
+                {
+                    processChunk(stream);
+                    std::lock_guard<std::mutex> lock(workersMutex);
+                    workersPerStream[stream].insert(pool.GetCurrentWorkerIndex());
+                };
+                results.push_back(nearStream ? pool.SubmitNear(stream, work) : pool.Submit(work));
+            }
+        }
+        for (auto& result : results)
+        {
+            result.get();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        size_t maxWorkers = 0;
+        for (const auto& workers : workersPerStream)
+        {
+            maxWorkers = (std::max)(maxWorkers, workers.size());
+        }
+        std::cout << (nearStream ? "SubmitNear" : "Submit") << ": 耗时 " << elapsed << "ms, 单个流最多经过 " << maxWorkers << " 个工作线程" << std::endl;
+    }
+
+    // 在工作线程内把后续任务留在本线程
+    auto followUp = pool.Submit([&pool]()
+    {
+        size_t self = pool.GetCurrentWorkerIndex();
+        return pool.SubmitTo(self, [&pool, self]() { return pool.GetCurrentWorkerIndex() == self; });
+    });
+    std::cout << "SubmitTo续接任务在同一线程执行: " << (followUp.get().get() ? "是" : "否") << std::endl;
+
+    pool.Shutdown();
+}
+
+/// <summary>
+/// 执行流水线测试：模拟解码、滤镜、编码三个阶段的转码流程，各阶段容量有限，输出端按输入顺序接收帧
+/// </summary>
+void TestPipeline()
+{
+    std::cout << "\n=== 流水线测试 ===\n" << std::endl;
+
+    struct ST_Frame
+    {
+        int m_index;                 ///< 帧序号
+        std::vector<uint8_t> m_data; ///< 帧数据
+    };
+
+    const int FRAME_COUNT = 300;
+    const size_t FRAME_SIZE = 64 * 1024;
+
+    ThreadPool pool;
+    Pipeline<ST_Frame> pipeline(pool);
+
+    // 解码：生成帧数据，耗时随帧变化
+    pipeline.AddStage("decode", [](ST_Frame& frame)
+    {
+        frame.m_data.assign(FRAME_SIZE, static_cast<uint8_t>(frame.m_index));
+        std::this_thread::sleep_for(std::chrono::microseconds(200 + (frame.m_index % 5) * 100));
+    }, 2);
+
+    // 滤镜：计算量最大的阶段，使用更高的并行度；丢弃每50帧中的一帧模拟跳帧
+    pipeline.AddStage("filter", [](ST_Frame& frame)
+    {
+        for (uint8_t& value : frame.m_data)
+        {
+            value = static_cast<uint8_t>(value * 3 + 1);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+        return frame.m_index % 50 != 49;
+    }, 4);
+
+    // 编码
+    pipeline.AddStage("encode", [](ST_Frame& frame)
+    {
+        frame.m_data.resize(frame.m_data.size() / 4);
+        std::this_thread::sleep_for(std::chrono::microseconds(300));
+    }, 2);
+
+    int lastIndex = -1;
+    bool inOrder = true;
+    size_t encodedBytes = 0;
+    pipeline.SetSink([&lastIndex, &inOrder, &encodedBytes](ST_Frame&& frame)
+    {
+        inOrder = inOrder && frame.m_index > lastIndex;
+        lastIndex = frame.m_index;
+        encodedBytes += frame.m_data.size();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        pipeline.Push(ST_Frame{ i, {} });
+    }
+    pipeline.Wait();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "输出帧数: " << pipeline.GetDeliveredCount() << "/" << FRAME_COUNT << ", 编码数据 " << encodedBytes / 1024 << "KB" << std::endl;
+    std::cout << "按输入顺序输出: " << (inOrder ? "是" : "否") << ", 耗时: " << elapsed << "ms" << std::endl;
+    for (const ST_PipelineStageStats& stats : pipeline.GetStageStats())
+    {
+        std::cout << "阶段 " << stats.m_name << ": 并行度 " << stats.m_parallelism << ", 容量 " << stats.m_capacity
+                  << ", 处理 " << stats.m_processed << ", 丢弃 " << stats.m_dropped << std::endl;
+    }
+}
+
+/// <summary>
+/// 执行调度配置档测试：同一线程池在运行时依次切换各配置档，对比稀疏提交的往返延迟、密集提交的吞吐量与工作线程休眠次数
+/// </summary>
+void TestSchedulingProfiles()
+{
+    std::cout << "\n=== 调度配置档测试 ===\n" << std::endl;
+
+    const int LATENCY_ROUNDS = 200;
+    const int BURST_TASKS = 100000;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    config.m_maxQueueSize = BURST_TASKS;
+    ThreadPool pool(config);
+
+    const std::pair<EM_SchedulingProfile, const char*> profiles[] = {
+        { EM_SchedulingProfile::Balanced, "Balanced" },
+        { EM_SchedulingProfile::LowLatency, "LowLatency" },
+        { EM_SchedulingProfile::Throughput, "Throughput" },
+        { EM_SchedulingProfile::Efficiency, "Efficiency" },
+    };
+
+    for (const auto& [profile, name] : profiles)
+    {
+        pool.SetSchedulingProfile(profile);
+        uint64_t parksBefore = pool.GetStats().m_parks;
+
+        // 稀疏提交：每次提交间隔一段时间，工作线程在两次提交之间进入空闲
+        std::vector<int64_t> latencies;
+        latencies.reserve(LATENCY_ROUNDS);
+        for (int i = 0; i < LATENCY_ROUNDS; ++i)
+        {
+            auto submitTime = std::chrono::steady_clock::now();
+            auto startTime = pool.Submit([]() { return std::chrono::steady_clock::now(); }).get();
+            latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(startTime - submitTime).count());
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        std::sort(latencies.begin(), latencies.end());
+
+        // 密集提交：连续提交大量小任务
+        std::atomic<int> completed{0};
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BURST_TASKS; ++i)
+        {
+            pool.Post([&completed]() { completed.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.WaitAll();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": 启动延迟中位数 " << latencies[LATENCY_ROUNDS / 2] << "us, P99 " << latencies[LATENCY_ROUNDS * 99 / 100]
+                  << "us, 吞吐 " << static_cast<int64_t>(completed.load()) * 1000000 / (std::max)(elapsed, static_cast<int64_t>(1))
+                  << " 任务/秒, 休眠次数 " << pool.GetStats().m_parks - parksBefore << std::endl;
+    }
+}
+
+/// <summary>
+/// 执行批量提交测试：每轮扇出一万个小任务，对比逐个Post与PostBulk的提交耗时和总耗时，并用SubmitBulk收集结果
+/// </summary>
+void TestBulkSubmission()
+{
+    std::cout << "\n=== 批量提交测试 ===\n" << std::endl;
+
+    const int FANOUT = 10000;
+    const int ROUNDS = 20;
+
+    ST_ThreadPoolConfig config;
+    config.m_minThreads = 4;
+    config.m_maxThreads = 4;
+    config.m_maxQueueSize = FANOUT * 2;
+    ThreadPool pool(config);
+
+    std::atomic<int64_t> sum{0};
+    auto makeTask = [&sum](int value) { return [&sum, value]() { sum.fetch_add(value, std::memory_order_relaxed); }; };
+    using TaskType = decltype(makeTask(0));
+
+    for (bool bulk : { false, true })
+    {
+        int64_t submitMicros = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+            std::vector<TaskType> tasks;
+            tasks.reserve(FANOUT);
+            for (int i = 0; i < FANOUT; ++i)
+            {
+                tasks.push_back(makeTask(i));
+            }
+
+            auto submitStart = std::chrono::steady_clock::now();
+            if (bulk)
+            {
+                pool.PostBulk(std::span(tasks));
+            }
+            else
+            {
+                for (auto& task : tasks)
+                {
+                    pool.Post(std::move(task));
+                }
+            }
+            submitMicros += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - submitStart).count();
+            pool.WaitAll();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << (bulk ? "PostBulk" : "逐个Post") << ": 每轮提交耗时 " << submitMicros / ROUNDS << "us, 总耗时 " << elapsed << "ms" << std::endl;
+    }
+    std::cout << "累加结果: " << sum.load() << " (期望 " << static_cast<int64_t>(FANOUT - 1) * FANOUT / 2 * ROUNDS * 2 << ")" << std::endl;
+
+    // 批量提交带返回值的任务
+    std::vector<std::function<int()>> squares;
+    for (int i = 0; i < 1000; ++i)
+    {
+        squares.push_back([i]() { return i * i; });
+    }
+    int64_t total = 0;
+    for (auto& future : pool.SubmitBulk(std::span(squares)))
+    {
+        total += future.get();
+    }
+    std::cout << "SubmitBulk平方和: " << total << std::endl;
+}
+
+/// <summary>
+/// 主函数
+/// </summary>
+int main()
+{
+    try
+    {
+        // 创建压力测试实例
+        // 参数：8个线程，每个线程100000条消息，每条消息128字节
+        LogSystemStressTest test(8, 100000, 128);
+        test.RunTest();
+    } catch (const std::exception& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+    try
+    {
+        std::cout << "=== 开始线程池性能测试 ===" << std::endl;
+
+        // 执行计算密集型任务测试
+        TestComputeBoundTasks();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行IO密集型任务测试
+        TestIOBoundTasks();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行混合优先级任务测试
+        TestMixedPriorityTasks();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行任务队列竞争测试
+        TestQueueContention();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行分治任务调度模式测试
+        TestWorkStealingTasks();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行任务派发延迟测试
+        TestDispatchLatency();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行微小任务提交吞吐测试
+        TestTinyTaskThroughput();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行任务续接测试
+        TestFutureContinuations();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行并行算法测试
+        TestParallelAlgorithms();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行任务依赖图测试
+        TestTaskGraph();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行协程调度测试
+        TestCoroutines();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行批量等待测试
+        TestBatchWait();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行定时任务测试
+        TestTimers();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行过载策略测试
+        TestOverloadPolicies();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行自适应线程数测试
+        TestAdaptiveSizing();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行串行执行器测试
+        TestStrands();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行专用线程测试
+        TestDedicatedThreads();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行工作线程放置测试
+        TestWorkerPlacement();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行任务取消测试
+        TestCancellation();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行阻塞补偿测试
+        TestBlockingCompensation();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行分片提交测试
+        TestShardedSubmission();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行线程亲和测试
+        TestWorkerAffinity();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行流水线测试
+        TestPipeline();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行调度配置档测试
+        TestSchedulingProfiles();
+
+        // 等待一段时间
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        // 执行批量提交测试
+        TestBulkSubmission();
 
         std::cout << "\n所有测试完成!" << std::endl;
     } catch (const std::exception& e)